@@ -0,0 +1,337 @@
+/**
+ * @file mcp_bench.cpp
+ * @brief Micro-benchmark suite for the MCP hot paths
+ *
+ * Measures ops/s and p50/p99/p999 latency for JSON parse/serialize, base64
+ * encode/decode, thread-pool enqueue, the event dispatcher send/wait
+ * ping-pong, and an end-to-end loopback HTTP round trip (ping and
+ * tools/list+tools/call, which exercises process_request dispatch and the
+ * list-cache serialization server-side).
+ *
+ * Usage:
+ *   mcp_bench [--no-http] [--out results.json] [--baseline results.json]
+ *
+ * --out writes the results as JSON; --baseline loads a previous --out file
+ * and prints the ops/s delta per benchmark so CI can diff runs.
+ */
+
+#include "mcp_server.h"
+#include "mcp_sse_client.h"
+#include "mcp_thread_pool.h"
+#include "base64.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct bench_result {
+    std::string name;
+    size_t iterations = 0;
+    double ops_per_sec = 0.0;
+    long long p50_ns = 0;
+    long long p99_ns = 0;
+    long long p999_ns = 0;
+};
+
+long long percentile(const std::vector<long long>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t idx = static_cast<size_t>(q * (sorted.size() - 1));
+    return sorted[idx];
+}
+
+// Run op() warmup+iters times, timing each call
+template<typename F>
+bench_result run_bench(const std::string& name, size_t iterations, size_t warmup, F&& op) {
+    for (size_t i = 0; i < warmup; ++i) {
+        op(i);
+    }
+
+    std::vector<long long> samples;
+    samples.reserve(iterations);
+
+    auto start = clock_type::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        auto t0 = clock_type::now();
+        op(warmup + i);
+        auto t1 = clock_type::now();
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    auto total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count();
+
+    std::sort(samples.begin(), samples.end());
+
+    bench_result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ops_per_sec = total_ns > 0 ? iterations * 1e9 / static_cast<double>(total_ns) : 0.0;
+    result.p50_ns = percentile(samples, 0.50);
+    result.p99_ns = percentile(samples, 0.99);
+    result.p999_ns = percentile(samples, 0.999);
+    return result;
+}
+
+void print_result(const bench_result& r) {
+    std::printf("%-28s %10zu ops  %12.0f ops/s  p50 %8lld ns  p99 %8lld ns  p999 %8lld ns\n",
+                r.name.c_str(), r.iterations, r.ops_per_sec, r.p50_ns, r.p99_ns, r.p999_ns);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+const char* sample_envelope =
+    R"({"jsonrpc":"2.0","id":42,"method":"tools/call","params":{"name":"echo",)"
+    R"("arguments":{"text":"the quick brown fox jumps over the lazy dog",)"
+    R"("values":[1,2,3,4,5,6,7,8],"nested":{"a":true,"b":null,"c":3.14}}}})";
+
+bench_result bench_json_parse(size_t iters) {
+    return run_bench("json_parse", iters, iters / 10, [&](size_t) {
+        mcp::json j = mcp::json::parse(sample_envelope);
+        if (!j.is_object()) std::abort();
+    });
+}
+
+bench_result bench_json_dump(size_t iters) {
+    mcp::json j = mcp::json::parse(sample_envelope);
+    return run_bench("json_dump", iters, iters / 10, [&](size_t) {
+        std::string s = j.dump();
+        if (s.empty()) std::abort();
+    });
+}
+
+bench_result bench_base64_encode(size_t iters) {
+    std::string data(64 * 1024, '\0');
+    std::mt19937 gen(12345);
+    for (auto& c : data) c = static_cast<char>(gen());
+    return run_bench("base64_encode_64k", iters, iters / 10, [&](size_t) {
+        std::string encoded = base64::encode(data);
+        if (encoded.empty()) std::abort();
+    });
+}
+
+bench_result bench_base64_decode(size_t iters) {
+    std::string data(64 * 1024, '\0');
+    std::mt19937 gen(54321);
+    for (auto& c : data) c = static_cast<char>(gen());
+    std::string encoded = base64::encode(data);
+    return run_bench("base64_decode_64k", iters, iters / 10, [&](size_t) {
+        std::string decoded = base64::decode(encoded);
+        if (decoded.size() != data.size()) std::abort();
+    });
+}
+
+bench_result bench_thread_pool_enqueue(size_t iters) {
+    mcp::thread_pool pool;
+    std::atomic<size_t> executed{0};
+    auto result = run_bench("thread_pool_enqueue", iters, iters / 10, [&](size_t) {
+        pool.enqueue([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+    });
+    // Let the queue drain so the pool shuts down cleanly
+    while (executed.load(std::memory_order_relaxed) < iters + iters / 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return result;
+}
+
+bench_result bench_dispatcher_pingpong(size_t iters) {
+    mcp::event_dispatcher dispatcher;
+    std::atomic<size_t> events_written{0};
+
+    std::thread consumer([&]() {
+        httplib::DataSink sink;
+        sink.write = [&](const char* /*data*/, size_t /*len*/) {
+            events_written.fetch_add(1, std::memory_order_release);
+            return true;
+        };
+        sink.is_writable = []() { return true; };
+        while (dispatcher.wait_event(&sink, std::chrono::milliseconds(100))) {
+        }
+    });
+
+    size_t sent = 0;
+    auto result = run_bench("dispatcher_pingpong", iters, iters / 10, [&](size_t) {
+        if (!dispatcher.send_event("event: message\r\ndata: {}\r\n\r\n")) std::abort();
+        ++sent;
+        // Round trip: wait until the consumer has written this event
+        while (events_written.load(std::memory_order_acquire) < sent) {
+        }
+    });
+
+    dispatcher.close();
+    consumer.join();
+    return result;
+}
+
+std::vector<bench_result> bench_http_loopback(size_t iters) {
+    mcp::server::configuration conf;
+    conf.host = "127.0.0.1";
+    conf.port = 18931;
+    conf.name = "BenchServer";
+    mcp::server srv(conf);
+
+    mcp::tool echo_tool = mcp::tool_builder("echo")
+        .with_description("echoes its input")
+        .with_string_param("text", "text to echo")
+        .build();
+    srv.register_tool(echo_tool, [](const mcp::json& params, const std::string&) -> mcp::json {
+        return mcp::json::array({{{"type", "text"}, {"text", params.value("text", "")}}});
+    });
+
+    if (!srv.start(false)) {
+        std::fprintf(stderr, "loopback server failed to start; skipping HTTP benchmarks\n");
+        return {};
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::vector<bench_result> results;
+    try {
+        mcp::sse_client client("http://127.0.0.1:18931");
+        if (!client.initialize("mcp_bench", "1.0")) {
+            std::fprintf(stderr, "loopback initialize failed; skipping HTTP benchmarks\n");
+            srv.stop();
+            return {};
+        }
+
+        results.push_back(run_bench("http_ping", iters, iters / 10, [&](size_t) {
+            if (!client.ping()) std::abort();
+        }));
+
+        results.push_back(run_bench("http_tools_list", iters, iters / 10, [&](size_t) {
+            if (client.get_tools().empty()) std::abort();
+        }));
+
+        results.push_back(run_bench("http_tools_call", iters, iters / 10, [&](size_t) {
+            mcp::json r = client.call_tool("echo", {{"text", "ping"}});
+            if (r.empty()) std::abort();
+        }));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "HTTP benchmark failed: %s\n", e.what());
+    }
+
+    srv.stop();
+    return results;
+}
+
+// ---------------------------------------------------------------------------
+// Output and baseline comparison
+// ---------------------------------------------------------------------------
+
+mcp::json results_to_json(const std::vector<bench_result>& results) {
+    mcp::json benchmarks = mcp::json::array();
+    for (const auto& r : results) {
+        benchmarks.push_back({
+            {"name", r.name},
+            {"iterations", r.iterations},
+            {"ops_per_sec", r.ops_per_sec},
+            {"p50_ns", r.p50_ns},
+            {"p99_ns", r.p99_ns},
+            {"p999_ns", r.p999_ns}
+        });
+    }
+    return {{"benchmarks", benchmarks}};
+}
+
+void compare_to_baseline(const std::vector<bench_result>& results, const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "cannot open baseline file: %s\n", path.c_str());
+        return;
+    }
+
+    mcp::json baseline;
+    try {
+        file >> baseline;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "cannot parse baseline file: %s\n", e.what());
+        return;
+    }
+
+    std::printf("\nComparison against %s (positive = faster):\n", path.c_str());
+    for (const auto& r : results) {
+        double base_ops = 0.0;
+        for (const auto& b : baseline.value("benchmarks", mcp::json::array())) {
+            if (b.value("name", "") == r.name) {
+                base_ops = b.value("ops_per_sec", 0.0);
+                break;
+            }
+        }
+        if (base_ops <= 0.0) {
+            std::printf("%-28s (no baseline entry)\n", r.name.c_str());
+            continue;
+        }
+        double delta = (r.ops_per_sec - base_ops) / base_ops * 100.0;
+        std::printf("%-28s %+8.2f%%  (%.0f -> %.0f ops/s)\n",
+                    r.name.c_str(), delta, base_ops, r.ops_per_sec);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    bool run_http = true;
+    std::string out_path;
+    std::string baseline_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-http") {
+            run_http = false;
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--no-http] [--out results.json] [--baseline results.json]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    // Keep the server quiet while benchmarking
+    mcp::set_log_level(mcp::log_level::error);
+
+    std::vector<bench_result> results;
+    results.push_back(bench_json_parse(100000));
+    print_result(results.back());
+    results.push_back(bench_json_dump(100000));
+    print_result(results.back());
+    results.push_back(bench_base64_encode(5000));
+    print_result(results.back());
+    results.push_back(bench_base64_decode(5000));
+    print_result(results.back());
+    results.push_back(bench_thread_pool_enqueue(100000));
+    print_result(results.back());
+    results.push_back(bench_dispatcher_pingpong(20000));
+    print_result(results.back());
+
+    if (run_http) {
+        for (auto& r : bench_http_loopback(500)) {
+            print_result(r);
+            results.push_back(std::move(r));
+        }
+    }
+
+    if (!out_path.empty()) {
+        std::ofstream out(out_path);
+        out << results_to_json(results).dump(2) << std::endl;
+        std::printf("\nresults written to %s\n", out_path.c_str());
+    }
+
+    if (!baseline_path.empty()) {
+        compare_to_baseline(results, baseline_path);
+    }
+
+    return 0;
+}
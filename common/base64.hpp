@@ -29,10 +29,15 @@ For more information, please refer to <http://unlicense.org>
 #define PUBLIC_DOMAIN_BASE64_HPP_
 
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
 #include <string>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 class base64_error : public std::runtime_error
 {
 public:
@@ -152,13 +157,7 @@ public:
     */
     static std::string encode(const std::string& str, alphabet alphabet = alphabet::standard)
     {
-        std::string result;
-
-        result.reserve(required_encode_size(str.length()) + 1);
-
-        encode(str.begin(), str.end(), std::back_inserter(result), alphabet);
-
-        return result;
+        return encode(str.data(), str.length(), alphabet);
     }
     /**
      Encodes a char array.
@@ -172,12 +171,125 @@ public:
     {
         std::string result;
 
-        result.reserve(required_encode_size(size) + 1);
+        result.resize(required_encode_size(size));
 
-        encode(buffer, buffer + size, std::back_inserter(result), alphabet);
+        if (size) {
+            result.resize(encode_into(buffer, size, &result[0], alphabet));
+        }
 
         return result;
     }
+    /**
+     Encodes a buffer into preallocated output memory.
+
+     The bulk of the input is processed in 3-byte groups through a branch-free
+     table lookup; when compiled with AVX2 support, 24-byte groups are encoded
+     with SIMD shuffles instead. The result is identical to base64::encode().
+
+     @warning The source and destination cannot overlap. The destination must be able to hold at least
+     `required_encode_size(size)` characters.
+
+     @param in the source buffer
+     @param size the size of the source buffer
+     @param out the destination buffer
+     @param alphabet which alphabet should be used
+     @returns the number of characters written to `out`
+    */
+    static std::size_t encode_into(const char* in, std::size_t size, char* out,
+                                   alphabet alphabet = alphabet::standard)
+    {
+        constexpr auto pad = '=';
+        const char* alpha  = alphabet == alphabet::url_filename_safe
+                                ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                                : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        char* const out_begin = out;
+        std::size_t i         = 0;
+
+#if defined(__AVX2__)
+        // Process 24 input bytes per iteration; the 32-byte load overreads,
+        // so stop while a full register still fits in the input
+        while (i + 32 <= size) {
+            __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+            // move input bytes 0..11 into the low lane (at byte 4) and
+            // bytes 12..23 into the high lane, as the shuffle below expects
+            data = _mm256_permutevar8x32_epi32(data, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+
+            // spread each 3-byte group over a 4-byte lane: [b1, b0, b2, b1]
+            data = _mm256_shuffle_epi8(data, _mm256_set_epi8(
+                10, 11, 9, 10,
+                7, 8, 6, 7,
+                4, 5, 3, 4,
+                1, 2, 0, 1,
+
+                14, 15, 13, 14,
+                11, 12, 10, 11,
+                8, 9, 7, 8,
+                5, 6, 4, 5));
+
+            // isolate the four 6-bit indices of each group
+            const __m256i t0 = _mm256_and_si256(data, _mm256_set1_epi32(0x0fc0fc00));
+            const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+            const __m256i t2 = _mm256_and_si256(data, _mm256_set1_epi32(0x003f03f0));
+            const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+            __m256i indices  = _mm256_or_si256(t1, t3);
+
+            // translate indices to ASCII by adding a range-dependent offset
+            const __m256i offsets = alphabet == alphabet::url_filename_safe
+                ? _mm256_setr_epi8(
+                    65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0,
+                    65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0)
+                : _mm256_setr_epi8(
+                    65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                    65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+            __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            range         = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                                _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range)));
+
+            out += 32;
+            i += 24;
+        }
+#endif
+
+        // Whole 3-byte groups
+        while (size - i >= 3) {
+            const std::uint8_t i0 = static_cast<std::uint8_t>(in[i]);
+            const std::uint8_t i1 = static_cast<std::uint8_t>(in[i + 1]);
+            const std::uint8_t i2 = static_cast<std::uint8_t>(in[i + 2]);
+
+            out[0] = alpha[i0 >> 2 & 0x3f];
+            out[1] = alpha[((i0 & 0x3) << 4) | (i1 >> 4 & 0x0f)];
+            out[2] = alpha[((i1 & 0xf) << 2) | (i2 >> 6 & 0x03)];
+            out[3] = alpha[i2 & 0x3f];
+
+            out += 4;
+            i += 3;
+        }
+
+        // Remaining 1 or 2 bytes plus padding
+        if (size - i == 1) {
+            const std::uint8_t i0 = static_cast<std::uint8_t>(in[i]);
+
+            out[0] = alpha[i0 >> 2 & 0x3f];
+            out[1] = alpha[(i0 & 0x3) << 4];
+            out[2] = pad;
+            out[3] = pad;
+            out += 4;
+        } else if (size - i == 2) {
+            const std::uint8_t i0 = static_cast<std::uint8_t>(in[i]);
+            const std::uint8_t i1 = static_cast<std::uint8_t>(in[i + 1]);
+
+            out[0] = alpha[i0 >> 2 & 0x3f];
+            out[1] = alpha[((i0 & 0x3) << 4) | (i1 >> 4 & 0x0f)];
+            out[2] = alpha[(i1 & 0xf) << 2];
+            out[3] = pad;
+            out += 4;
+        }
+
+        return static_cast<std::size_t>(out - out_begin);
+    }
     /**
      Decodes all the elements from `in_begin` to `in_end` to `out`. `in_begin` may point to the same location as `out`,
      in other words: inplace decoding is possible.
@@ -254,13 +366,7 @@ public:
     static std::string decode(const std::string& str, alphabet alphabet = alphabet::auto_,
                               decoding_behavior behavior = decoding_behavior::moderate)
     {
-        std::string result;
-
-        result.reserve(max_decode_size(str.length()));
-
-        decode(str.begin(), str.end(), std::back_inserter(result), alphabet, behavior);
-
-        return result;
+        return decode(str.data(), str.length(), alphabet, behavior);
     }
     /**
      Decodes a string.
@@ -277,12 +383,97 @@ public:
     {
         std::string result;
 
-        result.reserve(max_decode_size(size));
+        result.resize(max_decode_size(size));
 
-        decode(buffer, buffer + size, std::back_inserter(result), alphabet, behavior);
+        result.resize(size ? decode_into(buffer, size, &result[0], alphabet, behavior) : 0);
 
         return result;
     }
+    /**
+     Decodes a buffer into preallocated output memory.
+
+     Whole unpadded 4-character groups are decoded through a 256-entry lookup
+     table, four characters at a time; the remainder (padding, partial groups
+     or the first invalid character) is handed to the bit-accumulator loop of
+     base64::decode(). With `alphabet::auto_` both alphabets are accepted,
+     including mixed input.
+
+     @warning The source and destination cannot overlap. The destination must be able to hold at least
+     `max_decode_size(size)` bytes.
+
+     @param in the base64 encoded buffer
+     @param size the size of the buffer
+     @param out the destination buffer
+     @param alphabet which alphabet should be used
+     @param behavior the behavior when an error was detected
+     @returns the number of bytes written to `out`
+     @throws base64_error depending on the set behavior
+    */
+    static std::size_t decode_into(const char* in, std::size_t size, char* out,
+                                   alphabet alphabet          = alphabet::auto_,
+                                   decoding_behavior behavior = decoding_behavior::moderate)
+    {
+        const std::uint8_t* table = _decode_table(alphabet);
+        char* const out_begin     = out;
+        std::size_t i             = 0;
+
+        // Whole 4-character groups; the table marks '=' and invalid
+        // characters with the high bit, which drops us to the tail loop
+        while (size - i >= 4) {
+            const std::uint8_t v0 = table[static_cast<std::uint8_t>(in[i])];
+            const std::uint8_t v1 = table[static_cast<std::uint8_t>(in[i + 1])];
+            const std::uint8_t v2 = table[static_cast<std::uint8_t>(in[i + 2])];
+            const std::uint8_t v3 = table[static_cast<std::uint8_t>(in[i + 3])];
+
+            if ((v0 | v1 | v2 | v3) & 0x80) {
+                break;
+            }
+
+            out[0] = static_cast<char>((v0 << 2) | (v1 >> 4));
+            out[1] = static_cast<char>((v1 << 4) | (v2 >> 2));
+            out[2] = static_cast<char>((v2 << 6) | v3);
+
+            out += 3;
+            i += 4;
+        }
+
+        // Tail: padding, a partial group or an invalid character
+        std::uint8_t last = 0;
+        auto bits         = 0;
+
+        for (; i < size; ++i) {
+            auto c = in[i];
+
+            if (c == '=') {
+                break;
+            }
+
+            auto part = _base64_value(alphabet, c);
+
+            // enough bits for one byte
+            if (bits + 6 >= 8) {
+                *out = (last << (8 - bits)) | (part >> (bits - 2));
+                ++out;
+
+                bits -= 2;
+            } else {
+                bits += 6;
+            }
+
+            last = part;
+        }
+
+        // check padding
+        if (behavior != decoding_behavior::loose) {
+            for (; i < size; ++i) {
+                if (in[i] != '=') {
+                    throw base64_error("invalid base64 character.");
+                }
+            }
+        }
+
+        return static_cast<std::size_t>(out - out_begin);
+    }
     /**
      Decodes a string inplace.
 
@@ -341,6 +532,49 @@ public:
     }
 
 private:
+    /** 256-entry value tables; 0xff marks characters outside the alphabet. */
+    static const std::uint8_t* _decode_table(alphabet alphabet)
+    {
+        struct tables
+        {
+            std::uint8_t standard[256];
+            std::uint8_t url[256];
+            std::uint8_t any[256];
+
+            tables()
+            {
+                std::memset(standard, 0xff, sizeof(standard));
+                std::memset(url, 0xff, sizeof(url));
+                std::memset(any, 0xff, sizeof(any));
+
+                for (int c = 'A'; c <= 'Z'; ++c) {
+                    standard[c] = url[c] = any[c] = static_cast<std::uint8_t>(c - 'A');
+                }
+
+                for (int c = 'a'; c <= 'z'; ++c) {
+                    standard[c] = url[c] = any[c] = static_cast<std::uint8_t>(c - 'a' + 26);
+                }
+
+                for (int c = '0'; c <= '9'; ++c) {
+                    standard[c] = url[c] = any[c] = static_cast<std::uint8_t>(c - '0' + 52);
+                }
+
+                standard['+'] = any['+'] = 62;
+                standard['/'] = any['/'] = 63;
+                url['-'] = any['-'] = 62;
+                url['_'] = any['_'] = 63;
+            }
+        };
+
+        static const tables t;
+
+        switch (alphabet) {
+        case alphabet::standard: return t.standard;
+        case alphabet::url_filename_safe: return t.url;
+        default: return t.any;
+        }
+    }
+
     static std::uint8_t _base64_value(alphabet& alphabet, char c)
     {
         if (c >= 'A' && c <= 'Z') {
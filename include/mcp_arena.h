@@ -0,0 +1,220 @@
+/**
+ * @file mcp_arena.h
+ * @brief Thread-local bump arena for transient JSON allocations
+ *
+ * This file implements a bump allocator, an RAII scope that activates it for
+ * the current thread, and a std-style allocator that draws from the active
+ * arena. When the library is built with MCP_JSON_ARENA, mcp::json binds its
+ * node, array and object allocations to arena_allocator; while an arena_scope
+ * is active on a thread, those allocations become pointer bumps and their
+ * deallocations become no-ops, with the whole region recycled when the scope
+ * ends. Outside a scope the allocator falls back to the global heap, so
+ * long-lived values (caches, pending-request maps) behave exactly as before.
+ *
+ * The one rule: a value allocated inside a scope must not outlive it. Copy it
+ * outside the scope (or build it outside) if it has to persist.
+ */
+
+#ifndef MCP_ARENA_H
+#define MCP_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace mcp {
+
+/**
+ * @class arena
+ * @brief Growable bump allocator
+ *
+ * Memory is carved off the current block with a pointer bump; when a block is
+ * exhausted a larger one is added. reset() rewinds every block without
+ * returning memory to the system, so a reused arena reaches a steady state
+ * where no allocation touches the global heap.
+ */
+class arena {
+public:
+    explicit arena(size_t initial_block_size = 64 * 1024)
+        : next_block_size_(initial_block_size) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    /**
+     * @brief Allocate aligned storage from the arena
+     * @return The storage, or nullptr if the request exceeds what a block can hold
+     */
+    void* allocate(size_t bytes, size_t alignment) {
+        if (current_ < blocks_.size()) {
+            void* p = bump(blocks_[current_], bytes, alignment);
+            if (p) return p;
+        }
+
+        // Move to (or add) the next block, doubling until the request fits
+        while (next_block_size_ < bytes + alignment) {
+            next_block_size_ *= 2;
+        }
+        if (current_ + 1 < blocks_.size()) {
+            ++current_;
+        } else {
+            blocks_.push_back(block{std::make_unique<char[]>(next_block_size_), next_block_size_, 0});
+            current_ = blocks_.size() - 1;
+            next_block_size_ *= 2;
+        }
+        return bump(blocks_[current_], bytes, alignment);
+    }
+
+    /**
+     * @brief Rewind the arena, keeping its blocks for reuse
+     */
+    void reset() {
+        for (auto& b : blocks_) {
+            b.used = 0;
+        }
+        current_ = 0;
+    }
+
+    /**
+     * @brief Total capacity currently held by the arena's blocks
+     */
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& b : blocks_) {
+            total += b.capacity;
+        }
+        return total;
+    }
+
+    /**
+     * @brief The arena active on this thread, or nullptr
+     */
+    static arena* current() { return current_arena_; }
+
+private:
+    friend class arena_scope;
+
+    struct block {
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+        size_t used;
+    };
+
+    static void* bump(block& b, size_t bytes, size_t alignment) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(b.data.get()) + b.used;
+        uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        size_t needed = (aligned - base) + bytes;
+        if (b.used + needed > b.capacity) {
+            return nullptr;
+        }
+        b.used += needed;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    std::vector<block> blocks_;
+    size_t current_ = 0;
+    size_t next_block_size_;
+
+    static thread_local arena* current_arena_;
+};
+
+inline thread_local arena* arena::current_arena_ = nullptr;
+
+/**
+ * @class arena_scope
+ * @brief RAII activation of the thread-local arena
+ *
+ * The outermost scope on a thread activates a per-thread arena (reused across
+ * scopes, so blocks are allocated once and recycled) and resets it on exit.
+ * Nested scopes are no-ops: the outermost one owns the arena's lifetime.
+ */
+class arena_scope {
+public:
+    arena_scope() {
+        if (arena::current_arena_ == nullptr) {
+            arena::current_arena_ = &thread_arena();
+            owner_ = true;
+        }
+    }
+
+    ~arena_scope() {
+        if (owner_) {
+            arena::current_arena_->reset();
+            arena::current_arena_ = nullptr;
+        }
+    }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+private:
+    static arena& thread_arena() {
+        static thread_local arena instance;
+        return instance;
+    }
+
+    bool owner_ = false;
+};
+
+/**
+ * @class arena_allocator
+ * @brief std-style allocator backed by the active arena
+ *
+ * Allocations made while an arena_scope is active come from the arena and are
+ * reclaimed en masse when the scope ends (deallocate is a no-op for them).
+ * Without an active scope the allocator uses the global heap. Each allocation
+ * carries a one-word header recording its origin so deallocate frees exactly
+ * what came from the heap, which makes mixing scoped and unscoped lifetimes
+ * safe as long as arena-backed values do not escape their scope.
+ */
+template<typename T>
+class arena_allocator {
+public:
+    using value_type = T;
+
+    arena_allocator() noexcept = default;
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = header_size + n * sizeof(T);
+
+        if (arena* a = arena::current()) {
+            if (void* base = a->allocate(bytes, alignof(std::max_align_t))) {
+                *static_cast<size_t*>(base) = tag_arena;
+                return reinterpret_cast<T*>(static_cast<char*>(base) + header_size);
+            }
+        }
+
+        void* base = ::operator new(bytes);
+        *static_cast<size_t*>(base) = tag_heap;
+        return reinterpret_cast<T*>(static_cast<char*>(base) + header_size);
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        char* base = reinterpret_cast<char*>(p) - header_size;
+        if (*reinterpret_cast<size_t*>(base) == tag_heap) {
+            ::operator delete(base);
+        }
+        // Arena-backed storage is reclaimed when the scope resets
+    }
+
+    template<typename U>
+    bool operator==(const arena_allocator<U>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const arena_allocator<U>&) const noexcept { return false; }
+
+private:
+    // The header keeps the payload aligned for any fundamental type
+    static constexpr size_t header_size = alignof(std::max_align_t);
+    static constexpr size_t tag_arena = 0x41524E41; // "ARNA"
+    static constexpr size_t tag_heap = 0x48454150;  // "HEAP"
+};
+
+} // namespace mcp
+
+#endif // MCP_ARENA_H
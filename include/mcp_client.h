@@ -12,7 +12,9 @@
 #include "mcp_message.h"
 #include "mcp_tool.h"
 #include "mcp_logger.h"
+#include "mcp_client_cache.h"
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
@@ -131,6 +133,63 @@ public:
      * @return True if the client is running
      */
     virtual bool is_running() const = 0;
+
+    /**
+     * @brief Enable caching of rarely changing responses
+     * @param ttl How long a cached entry stays fresh
+     *
+     * Caches tools/list, resources/list, resources/templates/list and
+     * resources/read results in every transport. Entries are dropped early
+     * when the server sends the matching list_changed / updated
+     * notification, so the TTL only bounds staleness against servers that
+     * do not emit them. Disabled by default.
+     */
+    void enable_response_cache(std::chrono::milliseconds ttl) {
+        cache_ = std::make_unique<client_cache>(ttl);
+    }
+
+    /** Disable caching and drop all entries */
+    void disable_response_cache() {
+        cache_.reset();
+    }
+
+    /** Hit/miss/invalidation counters (zeros when caching is disabled) */
+    client_cache::stats get_cache_stats() const {
+        return cache_ ? cache_->get_stats() : client_cache::stats{};
+    }
+
+protected:
+    /** Look up a cached response; always a miss when caching is disabled */
+    bool cache_lookup(const std::string& key, json& value) {
+        return cache_ && cache_->lookup(key, value);
+    }
+
+    void cache_store(const std::string& key, const json& value) {
+        if (cache_) {
+            cache_->store(key, value);
+        }
+    }
+
+    /** Apply a server notification's invalidation side effects */
+    void cache_apply_notification(const std::string& method, const json& params) {
+        if (!cache_) {
+            return;
+        }
+        if (method == "notifications/tools/list_changed") {
+            cache_->invalidate("tools/list");
+        } else if (method == "notifications/resources/list_changed") {
+            cache_->invalidate("resources/list");
+            cache_->invalidate("resources/templates/list");
+        } else if (method == "notifications/resources/updated") {
+            if (params.contains("uri") && params["uri"].is_string()) {
+                cache_->invalidate("resources/read:" + params["uri"].get<std::string>());
+            } else {
+                cache_->invalidate_prefix("resources/read:");
+            }
+        }
+    }
+
+    std::unique_ptr<client_cache> cache_;
 };
 
 } // namespace mcp
@@ -0,0 +1,117 @@
+/**
+ * @file mcp_client_cache.h
+ * @brief TTL response cache for MCP clients
+ *
+ * This file implements an opt-in cache used by the client transports for
+ * request/response pairs that change rarely (tool lists, resource lists,
+ * resource contents). Entries expire after a configurable TTL and are
+ * invalidated eagerly when the server sends the corresponding list_changed /
+ * updated notifications, so the TTL only has to cover servers that do not
+ * emit them.
+ */
+
+#ifndef MCP_CLIENT_CACHE_H
+#define MCP_CLIENT_CACHE_H
+
+#include "mcp_message.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @class client_cache
+ * @brief Keyed JSON response cache with TTL expiry and hit/miss statistics
+ *
+ * Keys are the request method, plus a discriminator for parameterized
+ * requests (e.g. "resources/read:" + uri). Thread-safe; lookups prune the
+ * entry they hit when it has expired.
+ */
+class client_cache {
+public:
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0;
+    };
+
+    explicit client_cache(std::chrono::milliseconds ttl) : ttl_(ttl) {}
+
+    /** Look up a fresh entry; returns false (a miss) when absent or expired */
+    bool lookup(const std::string& key, json& value) {
+        const auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end()) {
+                if (now - it->second.stored_at < ttl_) {
+                    value = it->second.value;
+                    hits_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                entries_.erase(it);
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void store(const std::string& key, const json& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[key] = {value, std::chrono::steady_clock::now()};
+    }
+
+    /** Drop one key */
+    void invalidate(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.erase(key) > 0) {
+            invalidations_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /** Drop every key starting with the given prefix */
+    void invalidate_prefix(const std::string& prefix) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.lower_bound(prefix);
+        while (it != entries_.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = entries_.erase(it);
+            invalidations_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    stats get_stats() const {
+        stats s;
+        s.hits = hits_.load(std::memory_order_relaxed);
+        s.misses = misses_.load(std::memory_order_relaxed);
+        s.invalidations = invalidations_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct entry {
+        json value;
+        std::chrono::steady_clock::time_point stored_at;
+    };
+
+    std::chrono::milliseconds ttl_;
+    mutable std::mutex mutex_;
+    std::map<std::string, entry> entries_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> invalidations_{0};
+};
+
+} // namespace mcp
+
+#endif // MCP_CLIENT_CACHE_H
@@ -0,0 +1,197 @@
+/**
+ * @file mcp_json_scan.h
+ * @brief Streaming JSON-RPC envelope scanner
+ *
+ * This file implements a small forward-only scanner that extracts the
+ * JSON-RPC envelope fields (jsonrpc/id/method) and the raw byte range of
+ * `params` from a request body without building a DOM. It lets the server
+ * hand multi-megabyte tool arguments to a handler lazily instead of paying
+ * a full nlohmann parse for payloads it never needs as a tree.
+ *
+ * The scanner only walks structure (strings, nesting depth, separators); it
+ * does not validate numbers or unescape strings. Callers fall back to the
+ * regular DOM parse whenever a scan fails.
+ */
+
+#ifndef MCP_JSON_SCAN_H
+#define MCP_JSON_SCAN_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace mcp {
+namespace json_scan {
+
+inline void skip_whitespace(std::string_view s, size_t& i) {
+    while (i < s.size() &&
+           (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) {
+        ++i;
+    }
+}
+
+/** Advance past a JSON string; `i` must point at the opening quote. */
+inline bool skip_string(std::string_view s, size_t& i) {
+    if (i >= s.size() || s[i] != '"') {
+        return false;
+    }
+    ++i;
+    while (i < s.size()) {
+        if (s[i] == '\\') {
+            i += 2;
+        } else if (s[i] == '"') {
+            ++i;
+            return true;
+        } else {
+            ++i;
+        }
+    }
+    return false;
+}
+
+/** Advance past any JSON value (string, number, literal, object or array). */
+inline bool skip_value(std::string_view s, size_t& i) {
+    skip_whitespace(s, i);
+    if (i >= s.size()) {
+        return false;
+    }
+
+    char c = s[i];
+    if (c == '"') {
+        return skip_string(s, i);
+    }
+
+    if (c == '{' || c == '[') {
+        size_t depth = 0;
+        while (i < s.size()) {
+            c = s[i];
+            if (c == '"') {
+                if (!skip_string(s, i)) {
+                    return false;
+                }
+            } else {
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (depth == 0) {
+                        return false;
+                    }
+                    --depth;
+                    ++i;
+                    if (depth == 0) {
+                        return true;
+                    }
+                    continue;
+                }
+                ++i;
+            }
+        }
+        return false;
+    }
+
+    // Number or literal (true/false/null): consume until a delimiter
+    size_t start = i;
+    while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ']' &&
+           s[i] != ' ' && s[i] != '\t' && s[i] != '\n' && s[i] != '\r') {
+        ++i;
+    }
+    return i > start;
+}
+
+/**
+ * @brief Scan the members of a JSON object, invoking `field` per member
+ * @param s Text whose first non-whitespace character must be '{'
+ * @param field Callback receiving the (raw, unescaped) key and the raw value text
+ * @return True if the object was well-formed and fully scanned
+ */
+inline bool scan_object(std::string_view s,
+                        const std::function<void(std::string_view key, std::string_view value)>& field) {
+    size_t i = 0;
+    skip_whitespace(s, i);
+    if (i >= s.size() || s[i] != '{') {
+        return false;
+    }
+    ++i;
+
+    skip_whitespace(s, i);
+    if (i < s.size() && s[i] == '}') {
+        return true;
+    }
+
+    while (i < s.size()) {
+        skip_whitespace(s, i);
+        if (i >= s.size() || s[i] != '"') {
+            return false;
+        }
+        size_t key_start = i + 1;
+        if (!skip_string(s, i)) {
+            return false;
+        }
+        std::string_view key = s.substr(key_start, i - 1 - key_start);
+
+        skip_whitespace(s, i);
+        if (i >= s.size() || s[i] != ':') {
+            return false;
+        }
+        ++i;
+
+        skip_whitespace(s, i);
+        size_t value_start = i;
+        if (!skip_value(s, i)) {
+            return false;
+        }
+        field(key, s.substr(value_start, i - value_start));
+
+        skip_whitespace(s, i);
+        if (i < s.size() && s[i] == ',') {
+            ++i;
+            continue;
+        }
+        if (i < s.size() && s[i] == '}') {
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+/** Envelope fields of a single JSON-RPC message; raw fields keep the
+ *  original byte ranges inside the scanned body. */
+struct jsonrpc_envelope {
+    std::string_view jsonrpc;   // unquoted, e.g. "2.0"
+    std::string_view id_raw;    // raw JSON text of the id value
+    std::string_view method;    // unquoted method name
+    std::string_view params_raw; // raw JSON text of the params value
+};
+
+/** Strip the surrounding quotes off a raw string value (no unescaping). */
+inline std::string_view unquote(std::string_view raw) {
+    if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+        return raw.substr(1, raw.size() - 2);
+    }
+    return {};
+}
+
+/**
+ * @brief Extract the JSON-RPC envelope of a single request object
+ * @return True if `body` is a well-formed top-level object; batch arrays
+ *         and malformed input return false (caller falls back to DOM parse)
+ */
+inline bool scan_jsonrpc_envelope(std::string_view body, jsonrpc_envelope& out) {
+    return scan_object(body, [&](std::string_view key, std::string_view value) {
+        if (key == "jsonrpc") {
+            out.jsonrpc = unquote(value);
+        } else if (key == "id") {
+            out.id_raw = value;
+        } else if (key == "method") {
+            out.method = unquote(value);
+        } else if (key == "params") {
+            out.params_raw = value;
+        }
+    });
+}
+
+} // namespace json_scan
+} // namespace mcp
+
+#endif // MCP_JSON_SCAN_H
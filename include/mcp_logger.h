@@ -1,6 +1,12 @@
 /**
  * @file mcp_logger.h
  * @brief Simple logger
+ *
+ * Logs synchronously to stderr by default. An optional asynchronous backend
+ * (logger::set_async) moves console I/O off the calling thread: records are
+ * pushed into a bounded lock-free ring buffer and written by a dedicated
+ * drain thread, with a configurable drop-or-block policy when the buffer is
+ * full. The LOG_* macros are unaffected by the choice of backend.
  */
 
 #ifndef MCP_LOGGER_H
@@ -12,6 +18,12 @@
 #include <mutex>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <thread>
 
 namespace mcp {
 
@@ -24,75 +36,141 @@ enum class log_level {
 
 class logger {
 public:
+    /** What to do when the async ring buffer is full */
+    enum class overflow_policy {
+        /** drop the record and count it (never blocks the caller) */
+        drop,
+        /** wait for the drain thread to make room */
+        block
+    };
+
     static logger& instance() {
         static logger instance;
         return instance;
     }
-    
+
+    ~logger() {
+        async_.store(false, std::memory_order_release);
+        stop_drain_thread();
+    }
+
     void set_level(log_level level) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        level_ = level;
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Enable or disable the asynchronous backend
+     *
+     * Enabling starts the drain thread; disabling stops it after flushing
+     * everything already queued. Records logged while async is enabled are
+     * formatted on the calling thread but written to stderr by the drain
+     * thread, so the hot path never blocks on console I/O.
+     */
+    void set_async(bool enabled) {
+        std::lock_guard<std::mutex> lock(async_control_mutex_);
+
+        if (enabled == async_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        if (enabled) {
+            stop_drain_.store(false, std::memory_order_release);
+            drain_thread_ = std::thread([this]() { drain_loop(); });
+            async_.store(true, std::memory_order_release);
+        } else {
+            async_.store(false, std::memory_order_release);
+            stop_drain_thread();
+        }
     }
-    
+
+    /** Set the behavior when the async buffer is full (default: drop) */
+    void set_overflow_policy(overflow_policy policy) {
+        policy_.store(policy, std::memory_order_relaxed);
+    }
+
+    /** Number of records dropped because the async buffer was full */
+    size_t dropped_count() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
     template<typename... Args>
     void debug(Args&&... args) {
         log(log_level::debug, std::forward<Args>(args)...);
     }
-    
+
     template<typename... Args>
     void info(Args&&... args) {
         log(log_level::info, std::forward<Args>(args)...);
     }
-    
+
     template<typename... Args>
     void warning(Args&&... args) {
         log(log_level::warning, std::forward<Args>(args)...);
     }
-    
+
     template<typename... Args>
     void error(Args&&... args) {
         log(log_level::error, std::forward<Args>(args)...);
     }
-    
+
 private:
-    logger() : level_(log_level::info) {}
-    
+    logger() : level_(log_level::info) {
+        ring_ = std::make_unique<ring_cell[]>(ring_capacity_);
+        for (size_t i = 0; i < ring_capacity_; ++i) {
+            ring_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
     template<typename T>
     void log_impl(std::stringstream& ss, T&& arg) {
         ss << std::forward<T>(arg);
     }
-    
+
     template<typename T, typename... Args>
     void log_impl(std::stringstream& ss, T&& arg, Args&&... args) {
         ss << std::forward<T>(arg);
         log_impl(ss, std::forward<Args>(args)...);
     }
-    
-    template<typename... Args>
-    void log(log_level level, Args&&... args) {
-        if (level < level_) {
-            return;
-        }
-        
-        std::stringstream ss;
-        
-        // Add timestamp
+
+    // Render the timestamp at most once per second per thread; within the
+    // same second the cached text is reused instead of calling localtime
+    static void append_timestamp(std::stringstream& ss) {
         auto now = std::chrono::system_clock::now();
         auto now_c = std::chrono::system_clock::to_time_t(now);
+
+        static thread_local std::time_t cached_second = static_cast<std::time_t>(-1);
+        static thread_local char cached_text[24] = {0};
+
+        if (now_c != cached_second) {
 #if _CRT_SECURE_NO_WARNINGS
-        auto now_tm = std::localtime(&now_c);
+            auto now_tm = std::localtime(&now_c);
 #else
-        std::tm _tm;
+            std::tm _tm;
 #   ifdef _WIN32
-        localtime_s(&_tm, &now_c);
+            localtime_s(&_tm, &now_c);
 #   else
-        localtime_r(&now_c, &_tm);
+            localtime_r(&now_c, &_tm);
 #   endif
-        tm* now_tm = &_tm;
+            tm* now_tm = &_tm;
 #endif
+            std::strftime(cached_text, sizeof(cached_text), "%Y-%m-%d %H:%M:%S", now_tm);
+            cached_second = now_c;
+        }
+
+        ss << cached_text << " ";
+    }
+
+    template<typename... Args>
+    void log(log_level level, Args&&... args) {
+        if (level < level_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::stringstream ss;
+
+        // Add timestamp
+        append_timestamp(ss);
 
-        ss << std::put_time(now_tm, "%Y-%m-%d %H:%M:%S") << " ";
-        
         // Add log level and color
         switch (level) {
             case log_level::debug:
@@ -108,17 +186,172 @@ private:
                 ss << "\033[31m[ERROR]\033[0m ";   // Red
                 break;
         }
-        
+
         // Add log content
         log_impl(ss, std::forward<Args>(args)...);
-        
+
+        std::string line = ss.str();
+
+        if (async_.load(std::memory_order_acquire)) {
+            enqueue(std::move(line));
+            return;
+        }
+
         // Output log
         std::lock_guard<std::mutex> lock(mutex_);
-        std::cerr << ss.str() << std::endl;
+        std::cerr << line << std::endl;
+    }
+
+    // ------------------------------------------------------------------
+    // Asynchronous backend: bounded lock-free MPMC ring (sequence-numbered
+    // cells) drained by a single background thread
+    // ------------------------------------------------------------------
+
+    static constexpr size_t ring_capacity_ = 1024; // must be a power of two
+
+    struct ring_cell {
+        std::atomic<size_t> sequence;
+        std::string text;
+    };
+
+    bool try_push(std::string&& text) {
+        ring_cell* cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &ring_[pos & (ring_capacity_ - 1)];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->text = std::move(text);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(std::string& text) {
+        ring_cell* cell;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &ring_[pos & (ring_capacity_ - 1)];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (dif == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        text = std::move(cell->text);
+        cell->sequence.store(pos + ring_capacity_, std::memory_order_release);
+        return true;
+    }
+
+    void enqueue(std::string&& line) {
+        for (;;) {
+            if (try_push(std::move(line))) {
+                break;
+            }
+            if (policy_.load(std::memory_order_relaxed) == overflow_policy::drop) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Only signal when the drain thread is actually sleeping
+        if (drain_sleeping_.load(std::memory_order_acquire)) {
+            drain_cv_.notify_one();
+        }
+    }
+
+    void drain_loop() {
+        std::string line;
+        std::string batch;
+
+        for (;;) {
+            // Coalesce queued records into one write per batch
+            batch.clear();
+            size_t n = 0;
+            while (n < 256 && try_pop(line)) {
+                batch += line;
+                batch += '\n';
+                ++n;
+            }
+
+            if (n > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::cerr.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                std::cerr.flush();
+                continue;
+            }
+
+            if (stop_drain_.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lk(drain_mutex_);
+            drain_sleeping_.store(true, std::memory_order_release);
+            drain_cv_.wait_for(lk, std::chrono::milliseconds(100));
+            drain_sleeping_.store(false, std::memory_order_release);
+        }
     }
-    
-    log_level level_;
+
+    void stop_drain_thread() {
+        if (!drain_thread_.joinable()) {
+            return;
+        }
+
+        stop_drain_.store(true, std::memory_order_release);
+        drain_cv_.notify_one();
+        drain_thread_.join();
+
+        // Flush anything logged after the drain thread stopped popping
+        std::string line;
+        bool flushed = false;
+        while (try_pop(line)) {
+            std::cerr << line << "\n";
+            flushed = true;
+        }
+        if (flushed) {
+            std::cerr.flush();
+        }
+    }
+
+    std::atomic<log_level> level_;
     std::mutex mutex_;
+
+    std::unique_ptr<ring_cell[]> ring_;
+    std::atomic<size_t> enqueue_pos_{0};
+    std::atomic<size_t> dequeue_pos_{0};
+
+    std::atomic<bool> async_{false};
+    std::atomic<overflow_policy> policy_{overflow_policy::drop};
+    std::atomic<size_t> dropped_{0};
+
+    std::mutex async_control_mutex_;
+    std::thread drain_thread_;
+    std::atomic<bool> stop_drain_{false};
+    std::atomic<bool> drain_sleeping_{false};
+    std::mutex drain_mutex_;
+    std::condition_variable drain_cv_;
 };
 
 #define LOG_DEBUG(...) mcp::logger::instance().debug(__VA_ARGS__)
@@ -132,4 +365,4 @@ inline void set_log_level(log_level level) {
 
 } // namespace mcp
 
-#endif // MCP_LOGGER_H 
\ No newline at end of file
+#endif // MCP_LOGGER_H
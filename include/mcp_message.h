@@ -15,14 +15,29 @@
 #include <functional>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 // Include the JSON library for parsing and generating JSON
 #include "json.hpp"
 
+#ifdef MCP_JSON_ARENA
+#include "mcp_arena.h"
+#include <cstdint>
+#endif
+
 namespace mcp {
 
 // Use the nlohmann json library
+#ifdef MCP_JSON_ARENA
+// Same shape as ordered_json, but node/array/object allocations go through
+// the arena allocator: while an arena_scope is active they are bump
+// allocations reclaimed in bulk, otherwise they fall back to the global
+// heap. String payloads still use std::string's own allocator.
+using json = nlohmann::basic_json<nlohmann::ordered_map, std::vector, std::string, bool,
+                                  std::int64_t, std::uint64_t, double, arena_allocator>;
+#else
 using json = nlohmann::ordered_json;
+#endif
 
 // MCP version
 constexpr const char* MCP_VERSION = "2025-03-26";
@@ -57,33 +72,34 @@ struct request {
     std::string method;
     json params;
     
-    // Create a request
-    static request create(const std::string& method, const json& params = json::object()) {
+    // Create a request. Params are taken by value so callers handing over an
+    // rvalue (or a moved lvalue) pay no copy.
+    static request create(const std::string& method, json params = json::object()) {
         request req;
         req.jsonrpc = "2.0";
         req.id = generate_id();
         req.method = method;
-        req.params = params;
+        req.params = std::move(params);
         return req;
     }
-    
+
     // Create a request with a specific ID
-    static request create_with_id(const json& id, const std::string& method, const json& params = json::object()) {
+    static request create_with_id(json id, const std::string& method, json params = json::object()) {
         request req;
         req.jsonrpc = "2.0";
-        req.id = id;
+        req.id = std::move(id);
         req.method = method;
-        req.params = params;
+        req.params = std::move(params);
         return req;
     }
-    
+
     // Create a notification (no response expected)
-    static request create_notification(const std::string& method, const json& params = json::object()) {
+    static request create_notification(const std::string& method, json params = json::object()) {
         request req;
         req.jsonrpc = "2.0";
         req.id = nullptr;
         req.method = "notifications/" + method;
-        req.params = params;
+        req.params = std::move(params);
         return req;
     }
     
@@ -93,20 +109,40 @@ struct request {
     }
     
     // Convert to JSON
-    json to_json() const {
+    json to_json() const& {
         json j = {
             {"jsonrpc", jsonrpc},
             {"method", method}
         };
-        
+
         if (!params.empty()) {
             j["params"] = params;
         }
-        
+
         if (!is_notification()) {
             j["id"] = id;
         }
-        
+
+        return j;
+    }
+
+    // Rvalue overload: a request that is about to die donates its payload
+    // instead of copying it (picked automatically for temporaries, e.g.
+    // request::create(...).to_json())
+    json to_json() && {
+        json j = {
+            {"jsonrpc", jsonrpc},
+            {"method", method}
+        };
+
+        if (!params.empty()) {
+            j["params"] = std::move(params);
+        }
+
+        if (!is_notification()) {
+            j["id"] = std::move(id);
+        }
+
         return j;
     }
 
@@ -134,29 +170,30 @@ struct response {
     json result;
     json error;
     
-    // Create a success response
-    static response create_success(const json& req_id, const json& result_data = json::object()) {
+    // Create a success response. The result is taken by value so large tool
+    // results can be moved through instead of copied.
+    static response create_success(json req_id, json result_data = json::object()) {
         response res;
         res.jsonrpc = "2.0";
-        res.id = req_id;
-        res.result = result_data;
+        res.id = std::move(req_id);
+        res.result = std::move(result_data);
         return res;
     }
-    
+
     // Create an error response
-    static response create_error(const json& req_id, error_code code, const std::string& message, const json& data = json::object()) {
+    static response create_error(json req_id, error_code code, const std::string& message, json data = json::object()) {
         response res;
         res.jsonrpc = "2.0";
-        res.id = req_id;
+        res.id = std::move(req_id);
         res.error = {
             {"code", static_cast<int>(code)},
             {"message", message}
         };
-        
+
         if (!data.empty()) {
-            res.error["data"] = data;
+            res.error["data"] = std::move(data);
         }
-        
+
         return res;
     }
     
@@ -166,18 +203,37 @@ struct response {
     }
     
     // Convert to JSON
-    json to_json() const {
+    json to_json() const& {
         json j = {
             {"jsonrpc", jsonrpc},
             {"id", id}
         };
-        
+
         if (is_error()) {
             j["error"] = error;
         } else {
             j["result"] = result;
         }
-        
+
+        return j;
+    }
+
+    // Rvalue overload: moves the result/error payload out of a temporary
+    // response (e.g. response::create_success(...).to_json())
+    json to_json() && {
+        const bool has_error = is_error();
+
+        json j = {
+            {"jsonrpc", jsonrpc},
+            {"id", std::move(id)}
+        };
+
+        if (has_error) {
+            j["error"] = std::move(error);
+        } else {
+            j["result"] = std::move(result);
+        }
+
         return j;
     }
 
@@ -0,0 +1,273 @@
+/**
+ * @file mcp_metrics.h
+ * @brief Request metrics for the MCP server
+ *
+ * This file implements per-method call counters and log-bucketed latency
+ * histograms recorded on the request hot path, plus rendering to JSON
+ * (server::get_stats) and to the Prometheus text exposition format (the
+ * optional metrics endpoint). The dispatch path resolves a method's entry
+ * once per request through a read-mostly (shared-lock) lookup; recording
+ * the samples themselves is a handful of relaxed atomic increments.
+ * Building with MCP_DISABLE_METRICS compiles the recording sites out
+ * entirely.
+ */
+
+#ifndef MCP_METRICS_H
+#define MCP_METRICS_H
+
+#include "mcp_message.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+
+namespace mcp {
+
+/**
+ * @class latency_histogram
+ * @brief Fixed power-of-two-bucket latency histogram
+ *
+ * Samples are nanoseconds; bucket i holds samples in (2^(i-1), 2^i]. With 40
+ * buckets the histogram spans sub-microsecond to around 18 minutes, which
+ * covers every request this server will ever serve. All counters are relaxed
+ * atomics, so recording never takes a lock and percentiles are estimates
+ * read without one (each reported percentile is the upper bound of the
+ * bucket the quantile falls in).
+ */
+class latency_histogram {
+public:
+    static constexpr size_t bucket_count = 40;
+
+    void record(uint64_t ns) {
+        buckets_[bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+
+    uint64_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+    static size_t bucket_for(uint64_t ns) {
+        size_t b = 0;
+        while (b + 1 < bucket_count && (uint64_t(1) << b) < ns) {
+            ++b;
+        }
+        return b;
+    }
+
+    /** Upper bound (inclusive) of bucket i in nanoseconds */
+    static uint64_t bucket_upper_ns(size_t i) {
+        return uint64_t(1) << i;
+    }
+
+    /** Approximate percentile (upper bound of the bucket holding the quantile) */
+    uint64_t percentile_ns(double q) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+        if (rank == 0) rank = 1;
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            cumulative += bucket(i);
+            if (cumulative >= rank) {
+                return bucket_upper_ns(i);
+            }
+        }
+        return bucket_upper_ns(bucket_count - 1);
+    }
+
+    json to_json() const {
+        return {
+            {"count", count()},
+            {"sum_ns", sum_ns()},
+            {"p50_ns", percentile_ns(0.50)},
+            {"p99_ns", percentile_ns(0.99)},
+            {"p999_ns", percentile_ns(0.999)}
+        };
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[bucket_count]{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+};
+
+/**
+ * @struct method_metrics
+ * @brief Counters and latency distribution for one JSON-RPC method
+ */
+struct method_metrics {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> errors{0};
+    latency_histogram latency;
+
+    /** Record a successful invocation; relaxed atomics only */
+    void record_call(uint64_t ns) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        latency.record(ns);
+    }
+
+    /** Record an invocation that ended in an error (no latency sample,
+     *  so error paths do not skew the distribution) */
+    void record_error() {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        errors.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @class metrics_registry
+ * @brief Process-wide registry of request and event metrics
+ *
+ * Method entries are created on first use and never removed, so lookups
+ * after the first request for a method only take the reader side of a
+ * shared mutex. Callers resolve the entry once per request and record
+ * their samples directly on it, keeping the per-sample path free of any
+ * lookup or lock. The event dispatcher records into a dedicated histogram
+ * through the same singleton, keeping it decoupled from the server object.
+ */
+class metrics_registry {
+public:
+    static metrics_registry& instance() {
+        static metrics_registry instance;
+        return instance;
+    }
+
+    /**
+     * @brief Get (or create) the metrics entry for a method
+     *
+     * Entries are never removed, so the returned reference stays valid for
+     * the process lifetime and may be cached by the caller. Existing
+     * entries are found under a shared lock; only the first request for a
+     * method takes the exclusive lock to insert.
+     */
+    method_metrics& method(const std::string& name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = methods_.find(name);
+            if (it != methods_.end()) {
+                return *it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = methods_.find(name);
+        if (it == methods_.end()) {
+            it = methods_.emplace(name, std::make_unique<method_metrics>()).first;
+        }
+        return *it->second;
+    }
+
+    /** Record one event enqueued on a session dispatcher */
+    void record_event_send(uint64_t ns, bool ok) {
+        event_sends_.fetch_add(1, std::memory_order_relaxed);
+        if (!ok) {
+            event_send_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        event_latency_.record(ns);
+    }
+
+    json to_json() const {
+        json methods = json::object();
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            for (const auto& [name, m] : methods_) {
+                methods[name] = {
+                    {"calls", m->calls.load(std::memory_order_relaxed)},
+                    {"errors", m->errors.load(std::memory_order_relaxed)},
+                    {"latency", m->latency.to_json()}
+                };
+            }
+        }
+        return {
+            {"methods", methods},
+            {"events", {
+                {"sends", event_sends_.load(std::memory_order_relaxed)},
+                {"failures", event_send_failures_.load(std::memory_order_relaxed)},
+                {"latency", event_latency_.to_json()}
+            }}
+        };
+    }
+
+    /**
+     * @brief Render all metrics in the Prometheus text exposition format
+     * @param gauges Extra instantaneous gauges (name -> value) to append
+     */
+    std::string to_prometheus(const std::map<std::string, double>& gauges = {}) const {
+        std::ostringstream out;
+
+        out << "# TYPE mcp_requests_total counter\n";
+        out << "# TYPE mcp_request_errors_total counter\n";
+        out << "# TYPE mcp_request_duration_seconds histogram\n";
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            for (const auto& [name, m] : methods_) {
+                out << "mcp_requests_total{method=\"" << name << "\"} "
+                    << m->calls.load(std::memory_order_relaxed) << "\n";
+                out << "mcp_request_errors_total{method=\"" << name << "\"} "
+                    << m->errors.load(std::memory_order_relaxed) << "\n";
+                write_histogram(out, "mcp_request_duration_seconds",
+                                "method=\"" + name + "\",", m->latency);
+            }
+        }
+
+        out << "# TYPE mcp_event_sends_total counter\n";
+        out << "mcp_event_sends_total " << event_sends_.load(std::memory_order_relaxed) << "\n";
+        out << "# TYPE mcp_event_send_failures_total counter\n";
+        out << "mcp_event_send_failures_total "
+            << event_send_failures_.load(std::memory_order_relaxed) << "\n";
+        out << "# TYPE mcp_event_send_duration_seconds histogram\n";
+        write_histogram(out, "mcp_event_send_duration_seconds", "", event_latency_);
+
+        for (const auto& [name, value] : gauges) {
+            out << "# TYPE " << name << " gauge\n";
+            out << name << " " << value << "\n";
+        }
+
+        return out.str();
+    }
+
+private:
+    metrics_registry() = default;
+
+    static void write_histogram(std::ostringstream& out, const std::string& name,
+                                const std::string& label_prefix,
+                                const latency_histogram& histogram) {
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < latency_histogram::bucket_count; ++i) {
+            cumulative += histogram.bucket(i);
+            out << name << "_bucket{" << label_prefix << "le=\""
+                << static_cast<double>(latency_histogram::bucket_upper_ns(i)) / 1e9 << "\"} "
+                << cumulative << "\n";
+        }
+        out << name << "_bucket{" << label_prefix << "le=\"+Inf\"} "
+            << histogram.count() << "\n";
+
+        // label_prefix is either empty or "key=\"value\"," — strip the comma
+        const std::string labels = label_prefix.empty()
+            ? std::string()
+            : "{" + label_prefix.substr(0, label_prefix.size() - 1) + "}";
+        out << name << "_sum" << labels << " "
+            << static_cast<double>(histogram.sum_ns()) / 1e9 << "\n";
+        out << name << "_count" << labels << " " << histogram.count() << "\n";
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, std::unique_ptr<method_metrics>> methods_;
+
+    std::atomic<uint64_t> event_sends_{0};
+    std::atomic<uint64_t> event_send_failures_{0};
+    latency_histogram event_latency_;
+};
+
+} // namespace mcp
+
+#endif // MCP_METRICS_H
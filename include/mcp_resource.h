@@ -16,6 +16,8 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <atomic>
 
 namespace mcp {
 
@@ -218,16 +220,111 @@ public:
      */
     bool is_modified() const override;
 
-private:
-    std::string file_path_;
-    mutable time_t last_modified_;
-    
     /**
      * @brief Guess the MIME type from file extension
      * @param file_path The file path
      * @return The guessed MIME type
      */
     static std::string guess_mime_type(const std::string& file_path);
+
+private:
+    std::string file_path_;
+    mutable time_t last_modified_;
+};
+
+/**
+ * @class mmap_file_resource
+ * @brief Memory-mapped file resource for large files
+ *
+ * The mmap_file_resource class serves file content from a read-only memory
+ * mapping instead of copying the whole file on every read. The built content
+ * (including the base64 encoding for binary files) is cached and keyed on the
+ * file's modification time and size, so unchanged files are never re-read or
+ * re-encoded. Where mmap is unavailable the class falls back to a streaming
+ * read. Text-typed files are served as "text", everything else as a base64
+ * "blob", matching text_resource and binary_resource.
+ */
+class mmap_file_resource : public resource {
+public:
+    /**
+     * @brief Constructor
+     * @param file_path The path to the file
+     * @param mime_type The MIME type of the file (optional, will be guessed if not provided)
+     * @param description Optional description of the resource
+     */
+    mmap_file_resource(const std::string& file_path,
+                       const std::string& mime_type = "",
+                       const std::string& description = "");
+
+    /**
+     * @brief Destructor, releases the mapping
+     */
+    ~mmap_file_resource() override;
+
+    /**
+     * @brief Get resource metadata
+     * @return Metadata as JSON
+     */
+    json get_metadata() const override;
+
+    /**
+     * @brief Read the full resource content
+     * @return The resource content as JSON, served from the cached mapping
+     */
+    json read() const override;
+
+    /**
+     * @brief Read a byte range of the resource
+     * @param offset Byte offset to start from
+     * @param length Maximum number of bytes to return (clamped to the file end)
+     * @return The range content as JSON
+     *
+     * Ranges are served straight from the mapping and are not cached.
+     */
+    json read_range(size_t offset, size_t length) const;
+
+    /**
+     * @brief Check if the resource has been modified
+     * @return True if the file changed since the last read
+     */
+    bool is_modified() const override;
+
+    /**
+     * @brief Get the URI of the resource
+     * @return The URI as string
+     */
+    std::string get_uri() const override;
+
+private:
+    // Ensure the mapping matches the file on disk; remaps when the
+    // modification time or size changed. Must be called under mutex_.
+    void refresh_mapping() const;
+
+    // Release the current mapping (or fallback buffer). Must be called
+    // under mutex_.
+    void unmap() const;
+
+    // Whether the content should be served as "text" rather than "blob"
+    bool is_text_mime() const;
+
+    std::string file_path_;
+    std::string uri_;
+    std::string name_;
+    std::string mime_type_;
+    std::string description_;
+
+    mutable std::mutex mutex_;
+    mutable const char* data_ = nullptr;
+    mutable size_t size_ = 0;
+    mutable bool mapped_ = false;        // data_ points into an mmap region
+    mutable std::string fallback_;       // storage for the streaming fallback
+    mutable time_t mapped_mtime_ = -1;
+    mutable uintmax_t mapped_file_size_ = 0;
+    mutable json full_cache_;            // cached full read() result
+    mutable bool full_cache_valid_ = false;
+    // mtime at the time of the last read; atomic because is_modified()
+    // reads it without taking mutex_ while read()/read_range() update it
+    mutable std::atomic<time_t> served_mtime_{-1};
 };
 
 /**
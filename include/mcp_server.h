@@ -15,12 +15,17 @@
 #include "mcp_prompt.h"
 #include "mcp_thread_pool.h"
 #include "mcp_logger.h"
+#include "mcp_metrics.h"
+#include "mcp_session_registry.h"
+#include "mcp_shm_transport.h"
 
 // Include the HTTP library
 #include "httplib.h"
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <deque>
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -31,12 +36,17 @@
 #include <future>
 #include <atomic>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
 
 namespace mcp {
 
 using method_handler = std::function<json(const json&, const std::string&)>;
 using tool_handler = method_handler;
+/** Handler receiving the raw, unparsed JSON text of the tool arguments
+ *  (streaming parse mode — see server::register_tool_raw) */
+using raw_tool_handler = std::function<json(std::string_view, const std::string&)>;
 using prompt_handler = method_handler;
 using notification_handler = std::function<void(const json&, const std::string&)>;
 using auth_handler = std::function<bool(const std::string&, const std::string&)>;
@@ -44,10 +54,8 @@ using session_cleanup_handler = std::function<void(const std::string&)>;
 
 class event_dispatcher {
 public:
-    event_dispatcher() {
-        message_.reserve(128); // Pre-allocate space for messages
-    }
-    
+    event_dispatcher() = default;
+
     ~event_dispatcher() {
         close();
     }
@@ -57,7 +65,9 @@ public:
             return false;
         }
 
-        std::string message_copy;
+        // Take the whole batch of pending events out of the queue, then write
+        // them to the sink outside the lock so senders are never blocked on I/O
+        std::deque<event_chunk> batch;
         {
             std::unique_lock<std::mutex> lk(m_);
 
@@ -65,10 +75,8 @@ public:
                 return false;
             }
 
-            int id = id_.load(std::memory_order_relaxed);
-
             bool result = cv_.wait_for(lk, timeout, [&] {
-                return cid_.load(std::memory_order_relaxed) == id || closed_.load(std::memory_order_acquire);
+                return !pending_.empty() || closed_.load(std::memory_order_acquire);
             });
 
             if (closed_.load(std::memory_order_acquire)) {
@@ -79,20 +87,27 @@ public:
                 return false;
             }
 
-            // Only copy the message if there is one
-            if (!message_.empty()) {
-                message_copy.swap(message_);
-            } else {
-                return true; // No message but condition satisfied
-            }
+            batch.swap(pending_);
         }
 
         try {
-            if (!message_copy.empty()) {
-                if (!sink->write(message_copy.data(), message_copy.size())) {
-                    close();
-                    return false;
-                }
+            // Stitch the batch back into one buffer and write it as a single
+            // chunk: SSE clients with line-based parsers expect a complete
+            // event per read, and a multi-chunk event would be split across
+            // their callbacks. The copy happens here on the connection thread,
+            // so handlers still hand their payloads over without one.
+            size_t total = 0;
+            for (const auto& chunk : batch) {
+                total += chunk.text().size();
+            }
+            std::string buffer;
+            buffer.reserve(total);
+            for (const auto& chunk : batch) {
+                buffer.append(chunk.text());
+            }
+            if (!buffer.empty() && !sink->write(buffer.data(), buffer.size())) {
+                close();
+                return false;
             }
             return true;
         } catch (...) {
@@ -102,31 +117,131 @@ public:
     }
 
     bool send_event(const std::string& message) {
-        if (closed_.load(std::memory_order_acquire) || message.empty()) {
-            return false;
-        }
-        
-        try {
-            std::lock_guard<std::mutex> lk(m_);
-            
-            if (closed_.load(std::memory_order_acquire)) {
+        return send_event(std::string(message));
+    }
+
+    bool send_event(std::string&& message) {
+#ifndef MCP_DISABLE_METRICS
+        const auto send_start = std::chrono::steady_clock::now();
+#endif
+        bool ok = [&]() -> bool {
+            if (closed_.load(std::memory_order_acquire) || message.empty()) {
                 return false;
             }
-            
-            // Efficiently set the message and allocate space as needed
-            if (message.size() > message_.capacity()) {
-                message_.reserve(message.size() + 64); // Pre-allocate extra space to avoid frequent reallocations
+
+            try {
+                std::lock_guard<std::mutex> lk(m_);
+
+                if (closed_.load(std::memory_order_acquire) || pending_.size() >= max_pending_) {
+                    return false;
+                }
+
+                pending_.push_back(event_chunk(std::move(message)));
+
+                cv_.notify_one(); // Notify waiting threads
+                return true;
+            } catch (...) {
+                return false;
             }
-            message_ = message;
-            
-            cid_.store(id_.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
-            cv_.notify_one(); // Notify waiting threads
-            return true;
-        } catch (...) {
-            return false;
-        }
+        }();
+#ifndef MCP_DISABLE_METRICS
+        metrics_registry::instance().record_event_send(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - send_start).count(), ok);
+#endif
+        return ok;
     }
-    
+
+    /**
+     * @brief Queue a sequence of chunks that together form one logical event
+     *
+     * The chunks are moved into the pending queue as-is, so a handler
+     * producing a multi-megabyte payload hands it over without a copy; they
+     * are stitched back together on the connection thread just before the
+     * sink write. The caller is responsible for SSE framing (prefix/suffix
+     * chunks).
+     */
+    bool send_event_chunks(std::vector<std::string>&& chunks) {
+#ifndef MCP_DISABLE_METRICS
+        const auto send_start = std::chrono::steady_clock::now();
+#endif
+        bool ok = [&]() -> bool {
+            if (closed_.load(std::memory_order_acquire) || chunks.empty()) {
+                return false;
+            }
+
+            try {
+                std::lock_guard<std::mutex> lk(m_);
+
+                if (closed_.load(std::memory_order_acquire) ||
+                    pending_.size() + chunks.size() > max_pending_) {
+                    return false;
+                }
+
+                for (auto& chunk : chunks) {
+                    if (!chunk.empty()) {
+                        pending_.push_back(event_chunk(std::move(chunk)));
+                    }
+                }
+
+                cv_.notify_one();
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }();
+#ifndef MCP_DISABLE_METRICS
+        metrics_registry::instance().record_event_send(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - send_start).count(), ok);
+#endif
+        return ok;
+    }
+
+    /**
+     * @brief Queue one framed event whose payload is a shared immutable buffer
+     *
+     * Used by broadcasts: the serialized notification is produced once and
+     * every session's queue holds a reference to the same buffer instead of
+     * its own copy.
+     */
+    bool send_event_shared(std::string&& prefix,
+                           std::shared_ptr<const std::string> payload,
+                           std::string&& suffix) {
+#ifndef MCP_DISABLE_METRICS
+        const auto send_start = std::chrono::steady_clock::now();
+#endif
+        bool ok = [&]() -> bool {
+            if (closed_.load(std::memory_order_acquire) || !payload || payload->empty()) {
+                return false;
+            }
+
+            try {
+                std::lock_guard<std::mutex> lk(m_);
+
+                if (closed_.load(std::memory_order_acquire) ||
+                    pending_.size() + 3 > max_pending_) {
+                    return false;
+                }
+
+                pending_.push_back(event_chunk(std::move(prefix)));
+                pending_.push_back(event_chunk(std::move(payload)));
+                pending_.push_back(event_chunk(std::move(suffix)));
+
+                cv_.notify_one();
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }();
+#ifndef MCP_DISABLE_METRICS
+        metrics_registry::instance().record_event_send(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - send_start).count(), ok);
+#endif
+        return ok;
+    }
+
     void close() {
         bool was_closed = closed_.exchange(true, std::memory_order_release);
         if (was_closed) {
@@ -144,28 +259,143 @@ public:
         return closed_.load(std::memory_order_acquire);
     }
     
-    // Get the last activity time
+    // Get the last activity time (lock-free)
     std::chrono::steady_clock::time_point last_activity() const {
-        std::lock_guard<std::mutex> lk(m_);
-        return last_activity_;
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(
+            last_activity_.load(std::memory_order_relaxed)));
     }
-    
+
     // Update the activity time (when sending or receiving a message)
     void update_activity() {
-        std::lock_guard<std::mutex> lk(m_);
-        last_activity_ = std::chrono::steady_clock::now();
+        last_activity_.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                             std::memory_order_relaxed);
     }
 
+    // Heartbeats for this session are generated by the server's shared
+    // heartbeat timer; only legacy SSE sessions opt in
+    void enable_heartbeat() { heartbeat_enabled_.store(true, std::memory_order_relaxed); }
+    bool heartbeat_enabled() const { return heartbeat_enabled_.load(std::memory_order_relaxed); }
+    int next_heartbeat() { return heartbeat_count_.fetch_add(1, std::memory_order_relaxed); }
+
 private:
+    // Upper bound on queued chunks; a stalled client stops accepting events
+    // instead of buffering unboundedly
+    static constexpr size_t max_pending_ = 1024;
+
     mutable std::mutex m_;
     std::condition_variable cv_;
-    std::atomic<int> id_{0};
-    std::atomic<int> cid_{-1};
-    std::string message_;
+    // A queued chunk either owns its bytes or references a shared immutable
+    // buffer (broadcast payloads serialized once for many sessions)
+    struct event_chunk {
+        std::string owned;
+        std::shared_ptr<const std::string> shared;
+
+        explicit event_chunk(std::string&& text) : owned(std::move(text)) {}
+        explicit event_chunk(std::shared_ptr<const std::string> text) : shared(std::move(text)) {}
+
+        const std::string& text() const { return shared ? *shared : owned; }
+    };
+
+    std::deque<event_chunk> pending_;
     std::atomic<bool> closed_{false};
-    std::chrono::steady_clock::time_point last_activity_{std::chrono::steady_clock::now()};
+    std::atomic<bool> heartbeat_enabled_{false};
+    std::atomic<int> heartbeat_count_{0};
+
+    // Stored as steady_clock ticks so activity updates on the hot path are
+    // a single relaxed atomic store
+    std::atomic<std::chrono::steady_clock::rep> last_activity_{
+        std::chrono::steady_clock::now().time_since_epoch().count()};
 };
 
+/**
+ * @class tool_stream_writer
+ * @brief Pushes partial tool results to the caller while a handler runs
+ *
+ * Handed to handlers registered through server::register_tool_streaming.
+ * Events go straight into the session's event_dispatcher queue, so on the
+ * SSE transports the client sees the first chunk as soon as the handler
+ * produces it instead of waiting for the full tools/call response.
+ * Progress updates use the standard notifications/progress message
+ * (2025-03-26 spec) and are tied to the progressToken the caller supplied
+ * in _meta; partial content blocks go out as notifications/tools/call/partial.
+ * When the session has no event stream (plain stdio, no progressToken) the
+ * writer degrades to a no-op and the handler's return value is delivered
+ * as usual.
+ */
+class tool_stream_writer {
+public:
+    tool_stream_writer(std::shared_ptr<event_dispatcher> dispatcher, json progress_token)
+        : dispatcher_(std::move(dispatcher)), progress_token_(std::move(progress_token)) {}
+
+    /** Whether the session has a live event stream to push into */
+    bool is_live() const {
+        return dispatcher_ != nullptr && !dispatcher_->is_closed();
+    }
+
+    /**
+     * @brief Send a notifications/progress update
+     * @param progress Progress so far (monotonically increasing)
+     * @param total Expected total, or 0 when unknown
+     * @param message Optional human-readable status
+     * @return True if the event was queued
+     * @note A no-op when the caller supplied no progressToken, per spec.
+     */
+    bool send_progress(double progress, double total = 0.0, const std::string& message = "") {
+        if (progress_token_.is_null()) {
+            return false;
+        }
+        json params = {
+            {"progressToken", progress_token_},
+            {"progress", progress}
+        };
+        if (total > 0.0) {
+            params["total"] = total;
+        }
+        if (!message.empty()) {
+            params["message"] = message;
+        }
+        return send_notification("notifications/progress", std::move(params));
+    }
+
+    /**
+     * @brief Push one partial content block ahead of the final result
+     * @param content_block A content block ({"type":"text",...} etc.)
+     * @return True if the event was queued
+     */
+    bool send_content(const json& content_block) {
+        json params = {
+            {"content", json::array({content_block})}
+        };
+        if (!progress_token_.is_null()) {
+            params["progressToken"] = progress_token_;
+        }
+        return send_notification("notifications/tools/call/partial", std::move(params));
+    }
+
+private:
+    bool send_notification(const std::string& method, json&& params) {
+        if (!is_live()) {
+            return false;
+        }
+        json message = {
+            {"jsonrpc", "2.0"},
+            {"method", method},
+            {"params", std::move(params)}
+        };
+        std::vector<std::string> chunks;
+        chunks.emplace_back("event: message\r\ndata: ");
+        chunks.push_back(message.dump());
+        chunks.emplace_back("\r\n\r\n");
+        return dispatcher_->send_event_chunks(std::move(chunks));
+    }
+
+    std::shared_ptr<event_dispatcher> dispatcher_;
+    json progress_token_;
+};
+
+/** Handler producing the final content, pushing partial results on the way */
+using streaming_tool_handler = std::function<json(const json&, const std::string&, tool_stream_writer&)>;
+
 /**
  * @class server
  * @brief Main MCP server class
@@ -214,6 +444,21 @@ public:
         /** Inactive session timeout in seconds (0 = disabled) */
         unsigned int session_timeout{ MCP_SESSION_TIMEOUT };
 
+        /** Number of shards in the session registry */
+        unsigned int session_shards{ 16 };
+
+        /**
+         * Outbound notification coalescing window in milliseconds
+         * (0 = disabled). Notifications to a session queued within the
+         * window are merged into one SSE write, and duplicate
+         * resources/updated notifications for the same URI collapse to the
+         * latest one. Requests and responses are never delayed.
+         */
+        unsigned int notification_coalesce_ms{ 0 };
+
+        /** Path of the Prometheus metrics endpoint (empty = disabled) */
+        std::string metrics_endpoint{};
+
         #ifdef MCP_SSL        
         /**
          * @brief SSL configuration settings.
@@ -334,6 +579,62 @@ public:
      */
     void register_tool(const tool& tool, tool_handler handler);
 
+    /**
+     * @brief Register a tool with a typed handler
+     * @tparam Args The handler's parameter types, in order
+     * @param param_names One name per parameter, in the same order
+     * @param handler Callable taking (Args..., const std::string& session_id)
+     *
+     * The input schema is generated from the type list at compile time and
+     * each argument is looked up and converted exactly once per call, so the
+     * handler body works with native types instead of re-extracting values
+     * from the params JSON. Example:
+     *
+     *   srv.register_tool_typed<std::string, int>(
+     *       "repeat", "Repeats text", {"text", "count"},
+     *       [](std::string text, int count, const std::string&) -> json { ... });
+     */
+    template<typename... Args, typename F>
+    void register_tool_typed(const std::string& name, const std::string& description,
+                             const std::array<std::string, sizeof...(Args)>& param_names,
+                             F&& handler) {
+        tool typed_tool = build_typed_tool<Args...>(name, description, param_names);
+        register_tool(typed_tool,
+                      [param_names, handler = std::forward<F>(handler)](
+                          const json& params, const std::string& session_id) mutable -> json {
+            return invoke_typed_tool<Args...>(handler, param_names, params, session_id,
+                                              std::index_sequence_for<Args...>{});
+        });
+    }
+
+    /**
+     * @brief Register a tool whose arguments are handed over unparsed
+     * @param tool The tool to register
+     * @param handler Function receiving the raw JSON text of 'arguments'
+     *
+     * Streaming parse mode: on the Streamable HTTP transport, a tools/call
+     * for a tool registered here skips the full DOM parse of the request
+     * body — only the JSON-RPC envelope is scanned and the raw argument
+     * bytes are passed through, so handlers consuming large payloads
+     * (or forwarding them verbatim) avoid a parse/serialize round trip.
+     * On other paths (legacy SSE transport, batches, stdio) the handler
+     * receives the serialized form of the already-parsed arguments.
+     */
+    void register_tool_raw(const tool& tool, raw_tool_handler handler);
+
+    /**
+     * @brief Register a tool that streams partial results while it runs
+     * @param tool The tool to register
+     * @param handler Function receiving (arguments, session_id, writer)
+     *
+     * The writer pushes progress notifications and partial content blocks
+     * through the session's event stream as the handler produces them (see
+     * tool_stream_writer), so time-to-first-byte for long-running tools
+     * drops to the first chunk. The handler's return value is still
+     * delivered as the final tools/call result.
+     */
+    void register_tool_streaming(const tool& tool, streaming_tool_handler handler);
+
     /**
      * @brief Register a prompt
      * @param prompt The prompt to register
@@ -341,13 +642,69 @@ public:
      */
     void register_prompt(const prompt& prompt, prompt_handler handler);
 
+    /**
+     * @brief Write the built registries to a snapshot file
+     * @param path Destination file path
+     * @return True if the snapshot was written
+     *
+     * The snapshot holds the fully built tool, prompt and resource-template
+     * metadata (names, descriptions, input schemas) behind a versioned
+     * header with a content hash, so a later boot can skip re-running the
+     * schema builders. Handlers are code and are not captured.
+     */
+    bool save_registry_snapshot(const std::string& path) const;
+
+    /**
+     * @brief Restore the registries from a snapshot file
+     * @param path Snapshot written by save_registry_snapshot()
+     * @return True if the snapshot was valid and loaded
+     *
+     * The file is mapped, validated by magic/version/hash and decoded in one
+     * pass; tools, prompts and resource templates come back with their
+     * schemas prebuilt and the list caches primed, but with no handlers
+     * bound. Attach handlers afterwards with bind_tool_handler() /
+     * bind_prompt_handler() / bind_resource_template_handler(); calling an
+     * unbound entry fails with a clear error. Intended for an empty server
+     * at boot — loaded entries replace same-named ones.
+     */
+    bool load_registry_snapshot(const std::string& path);
+
+    /**
+     * @brief Attach a handler to a snapshot-loaded tool
+     * @return True if the tool exists in the registry
+     *
+     * Unlike register_tool() this does not touch the tool's schema or
+     * invalidate the primed tools/list cache.
+     */
+    bool bind_tool_handler(const std::string& name, tool_handler handler);
+
+    /** Attach a handler to a snapshot-loaded prompt (see bind_tool_handler) */
+    bool bind_prompt_handler(const std::string& name, prompt_handler handler);
+
+    /** Attach a handler to a snapshot-loaded resource template */
+    bool bind_resource_template_handler(const std::string& uri_template,
+                                        resource_template_handler handler);
+
     /**
      * @brief Register a session cleanup handler
      * @param key Tool or resource name to be cleaned up
      * @param handler The function to call when the session is closed
      */
     void register_session_cleanup(const std::string& key, session_cleanup_handler handler);
-    
+
+    /**
+     * @brief Get the per-session typed key/value store
+     * @param session_id The session ID handed to the handler
+     * @return The session's context, or nullptr if the session does not exist
+     *
+     * The context is allocated when the session enters the registry and torn
+     * down when the session closes, so stateful tool handlers can park state
+     * here instead of each maintaining its own session-keyed map. The
+     * returned pointer stays valid for the duration of the call even if the
+     * session is closed concurrently.
+     */
+    std::shared_ptr<session_context> get_session_context(const std::string& session_id) const;
+
     /**
      * @brief Get the list of available tools
      * @return JSON array of available tools
@@ -372,8 +729,20 @@ public:
     /**
      * @brief Broadcast a notification to all connected, initialized sessions
      * @param notification The notification to send (must be a JSON-RPC notification, i.e. no id)
+     * @return A future that completes once every session has been handed the message
+     *
+     * The notification is serialized once into a shared buffer and delivered
+     * in parallel on the server's thread pool, so the caller is not stalled
+     * by per-session locks. The future may be ignored for fire-and-forget.
+     */
+    std::future<void> broadcast_notification(const request& notification);
+
+    /**
+     * @brief Get a snapshot of the server's runtime metrics
+     * @return Per-method call/error counts and latency percentiles, event
+     *         dispatcher send statistics, thread pool and session gauges
      */
-    void broadcast_notification(const request& notification);
+    json get_stats() const;
 
     /**
      * @brief Get list of active session IDs
@@ -404,19 +773,17 @@ private:
     // Server thread (for non-blocking mode)
     std::unique_ptr<std::thread> server_thread_;
 
-    // SSE thread
-    std::map<std::string, std::unique_ptr<std::thread>> sse_threads_;
-
     // Event dispatcher for server-sent events
     event_dispatcher sse_dispatcher_;
-    
-    // Session-specific event dispatchers
-    std::map<std::string, std::shared_ptr<event_dispatcher>> session_dispatchers_;
+
+    // Sharded session registry (dispatchers, initialized flags, SSE threads)
+    session_registry sessions_;
 
     // Endpoint paths
     std::string sse_endpoint_;
     std::string msg_endpoint_;
     std::string mcp_endpoint_;
+    std::string metrics_endpoint_;
     
     // Method handlers
     std::map<std::string, method_handler> method_handlers_;
@@ -437,9 +804,40 @@ private:
     };
     std::vector<resource_template_entry> resource_templates_;
 
+    // Matching index over the templates' static prefixes (the part of the
+    // template before the first '{'), maintained at registration time.
+    // resources/read resolves a URI with one hash probe per distinct prefix
+    // length (longest first, so the most specific template wins) instead of
+    // pattern-matching every registered template.
+    std::unordered_map<std::string, std::vector<size_t>> template_prefix_index_;
+    std::vector<size_t> template_prefix_lengths_;  // distinct, descending
+
+    // Bounded cache of recently resolved uri -> template bindings for
+    // repeated reads of the same resource; cleared on registration
+    static constexpr size_t template_match_cache_limit = 1024;
+    mutable std::mutex template_cache_mutex_;
+    mutable std::unordered_map<std::string, size_t> template_match_cache_;
+
+    // Resolve a URI against the template index; fills params and returns the
+    // matching entry, or nullptr when no template matches
+    const resource_template_entry* find_resource_template(
+        const std::string& uri, std::map<std::string, std::string>& params) const;
+
     // Tools map (name -> handler)
     std::map<std::string, std::pair<tool, tool_handler>> tools_;
+    // Tools registered in streaming parse mode (name -> raw handler)
+    std::map<std::string, std::pair<tool, raw_tool_handler>> raw_tools_;
+    // Tools with a streaming handler (name -> handler)
+    std::map<std::string, std::pair<tool, streaming_tool_handler>> streaming_tools_;
     std::map<std::string, std::pair<prompt, prompt_handler>> prompts_;
+
+    // Cached list results (null = dirty); rebuilt lazily on the first
+    // tools/list, prompts/list or resources/list call after a registry
+    // mutation instead of on every request
+    mutable std::mutex list_cache_mutex_;
+    mutable json tools_list_cache_;
+    mutable json prompts_list_cache_;
+    mutable json resources_list_cache_;
     
     // Authentication handler
     auth_handler auth_handler_;
@@ -458,9 +856,6 @@ private:
     
     // Thread pool for async method handlers
     thread_pool thread_pool_;
-    
-    // Map to track session initialization status (session_id -> initialized)
-    std::map<std::string, bool> session_initialized_;
 
     // Legacy HTTP+SSE transport (2024-11-05)
     void handle_sse(const httplib::Request& req, httplib::Response& res);
@@ -474,6 +869,13 @@ private:
     // Parse a single JSON-RPC message from JSON
     request parse_jsonrpc_message(const json& j) const;
 
+    // Register the tools/list and tools/call method handlers (mutex_ held)
+    void register_tool_method_handlers();
+
+    // Streaming parse fast path for tools/call on a raw-registered tool;
+    // returns true if the request was fully handled
+    bool try_handle_raw_tool_call(const std::string& body, const std::string& session_id, httplib::Response& res);
+
     // Send a JSON-RPC message to a client
     void send_jsonrpc(const std::string& session_id, const json& message);
     
@@ -494,9 +896,12 @@ private:
     
     // Auxiliary function to create an async handler from a regular handler
     template<typename F>
-    std::function<std::future<json>(const json&, const std::string&)> make_async_handler(F&& handler) {
-        return [handler = std::forward<F>(handler)](const json& params, const std::string& session_id) -> std::future<json> {
-            return std::async(std::launch::async, [handler, params, session_id]() -> json {
+    std::function<std::future<json>(json, std::string)> make_async_handler(F&& handler) {
+        return [handler = std::forward<F>(handler)](json params, std::string session_id) -> std::future<json> {
+            // Move the params into the task instead of copying them; std::async
+            // decay-copies the lambda by move, so they travel with it
+            return std::async(std::launch::async,
+                              [handler, params = std::move(params), session_id = std::move(session_id)]() -> json {
                 return handler(params, session_id);
             });
         };
@@ -515,14 +920,89 @@ private:
         return auto_lock(mutex_);
     }
 
+    // Stdio transport engines. The portable engine is the original blocking
+    // getline loop; on Linux an epoll-driven engine reads stdin non-blocking,
+    // dispatches requests onto the thread pool and coalesces responses into
+    // vectored writes. Responses may complete out of order; JSON-RPC clients
+    // correlate by id.
+    void run_stdio_portable(const std::string& session_id);
+#ifdef __linux__
+    void run_stdio_epoll(const std::string& session_id);
+#endif
+
+    // Dispatch one decoded stdio JSON-RPC message; returns the response
+    // JSON, or null if there is nothing to write back
+    json dispatch_stdio_json(const json& req_json, const std::string& session_id);
+
+    // Parse and dispatch one newline-framed stdio message; returns the
+    // serialized response line (with trailing newline) or an empty string if
+    // there is nothing to write back
+    std::string handle_stdio_message(const std::string& line, const std::string& session_id);
+
+    // Binary framing mode (negotiated via capabilities.experimental.
+    // binary_framing): frames are a 4-byte little-endian length prefix plus a
+    // MessagePack body, so payloads may embed newlines and binary content
+    // without text escaping. The returned string is the fully framed reply.
+    std::string handle_stdio_binary_frame(const std::string& frame, const std::string& session_id);
+    void try_accept_binary_framing(const json& params, json& result);
+    std::atomic<bool> stdio_binary_{false};
+    // Upper bound on one binary frame; anything larger is a corrupt stream
+    static constexpr uint32_t max_stdio_frame_size = 256u * 1024 * 1024;
+
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    // Shared-memory fast path for co-located stdio clients, negotiated
+    // through capabilities.experimental.shm in the initialize request. An
+    // accepted channel gets a dedicated service thread; the pipe stays open
+    // as a fallback for oversized frames.
+    void try_accept_shm_offer(const json& params, json& result, const std::string& session_id);
+    void run_shm_channel(std::shared_ptr<shm_channel> channel, const std::string& session_id);
+    void shutdown_shm_channels();
+
+    std::mutex shm_mutex_;
+    std::vector<std::pair<std::shared_ptr<shm_channel>, std::thread>> shm_channels_;
+#endif
+
     // Session management and maintenance
     void check_inactive_sessions();
 
+    // Send one heartbeat event to every legacy SSE session; sessions whose
+    // queue rejects the event are closed. Runs on the shared heartbeat timer
+    // instead of a thread per connection.
+    void send_sse_heartbeats();
+
     std::mutex maintenance_mutex_;
     std::condition_variable maintenance_cond_;
     std::unique_ptr<std::thread> maintenance_thread_;
     bool maintenance_thread_run_ = false;
 
+    std::mutex heartbeat_mutex_;
+    std::condition_variable heartbeat_cond_;
+    std::unique_ptr<std::thread> heartbeat_thread_;
+    bool heartbeat_thread_run_ = false;
+
+    // Outbound notification coalescing (see configuration::notification_coalesce_ms).
+    // Notifications queue into a per-session batch; the flush thread drains
+    // batches whose window has elapsed into a single SSE write per session.
+    struct notification_batch {
+        std::vector<json> messages;
+        // URI -> index into messages, for collapsing resources/updated bursts
+        std::map<std::string, size_t> updated_uris;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    // Add one notification to the session's batch (starts its window)
+    void queue_notification(const std::string& session_id, const json& message);
+
+    // Send every batch whose window has elapsed (or all of them when forced)
+    void flush_notification_batches(bool force);
+
+    unsigned int notification_coalesce_ms_ = 0;
+    std::mutex coalesce_mutex_;
+    std::condition_variable coalesce_cond_;
+    std::map<std::string, notification_batch> notification_batches_;
+    std::unique_ptr<std::thread> coalesce_thread_;
+    bool coalesce_thread_run_ = false;
+
     // Session cleanup handler
     std::map<std::string, session_cleanup_handler> session_cleanup_handler_;
 
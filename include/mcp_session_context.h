@@ -0,0 +1,109 @@
+/**
+ * @file mcp_session_context.h
+ * @brief Per-session typed key/value store for tool handlers
+ *
+ * This file implements the session context handed to tool handlers that need
+ * state scoped to one client session. One context is allocated when the
+ * session enters the registry and destroyed when the session is closed, so
+ * stateful tools no longer need to maintain their own session-keyed maps.
+ */
+
+#ifndef MCP_SESSION_CONTEXT_H
+#define MCP_SESSION_CONTEXT_H
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+namespace mcp {
+
+/**
+ * @class session_context
+ * @brief Typed key/value store scoped to one session
+ *
+ * Values are stored type-erased and handed back as shared_ptr<T>, with the
+ * stored type checked on every access so two tools disagreeing about a key's
+ * type fail loudly instead of aliasing memory. Reads take a shared lock, so
+ * handler threads reading established state never block each other; only
+ * the first get_or_create() for a key takes the exclusive lock.
+ */
+class session_context {
+public:
+    /**
+     * @brief Look up a value by key
+     * @tparam T The type the value was stored as
+     * @return The value, or nullptr if the key is absent or holds another type
+     */
+    template<typename T>
+    std::shared_ptr<T> get(const std::string& key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end() || it->second.type != std::type_index(typeid(T))) {
+            return nullptr;
+        }
+        return std::static_pointer_cast<T>(it->second.value);
+    }
+
+    /**
+     * @brief Look up a value, default-constructing it on first access
+     * @tparam T The type to store; must be default-constructible
+     * @return The existing or newly created value (never nullptr)
+     *
+     * If the key already holds a value of a different type, that value is
+     * replaced — the last registration wins, matching the register_* methods.
+     */
+    template<typename T>
+    std::shared_ptr<T> get_or_create(const std::string& key) {
+        if (auto existing = get<T>(key)) {
+            return existing;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.type == std::type_index(typeid(T))) {
+            return std::static_pointer_cast<T>(it->second.value);
+        }
+        auto value = std::make_shared<T>();
+        entries_[key] = {std::type_index(typeid(T)), value};
+        return value;
+    }
+
+    /**
+     * @brief Store a value under a key, replacing any previous value
+     */
+    template<typename T>
+    void set(const std::string& key, std::shared_ptr<T> value) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        entries_[key] = {std::type_index(typeid(T)), std::move(value)};
+    }
+
+    /**
+     * @brief Remove a key
+     * @return True if the key existed
+     */
+    bool erase(const std::string& key) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        return entries_.erase(key) > 0;
+    }
+
+    /** Number of stored entries */
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct entry {
+        std::type_index type{typeid(void)};
+        std::shared_ptr<void> value;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, entry> entries_;
+};
+
+} // namespace mcp
+
+#endif // MCP_SESSION_CONTEXT_H
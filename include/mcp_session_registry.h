@@ -0,0 +1,312 @@
+/**
+ * @file mcp_session_registry.h
+ * @brief Sharded session registry for the MCP server
+ *
+ * This file implements a sharded registry for session state (event dispatchers,
+ * per-session context stores and initialization flags). Lookups hash the session ID to one of several
+ * independently locked shards, so concurrent requests for different sessions
+ * no longer serialize on a single global mutex.
+ */
+
+#ifndef MCP_SESSION_REGISTRY_H
+#define MCP_SESSION_REGISTRY_H
+
+#include "mcp_session_context.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mcp {
+
+class event_dispatcher;
+
+/**
+ * @class session_registry
+ * @brief Sharded map of session ID to per-session state
+ *
+ * Each shard owns its own mutex and maps, so the cost of a dispatcher lookup or
+ * an initialized-state check is one uncontended lock in the common case. The
+ * shard count is fixed at construction time and is configurable through
+ * server::configuration::session_shards.
+ */
+class session_registry {
+public:
+    /** Resources handed back to the caller when a session is removed,
+     *  so closing can happen outside any shard lock. */
+    struct removed_session {
+        std::shared_ptr<event_dispatcher> dispatcher;
+        std::shared_ptr<session_context> context;
+    };
+
+    explicit session_registry(unsigned int shard_count = 16) {
+        if (shard_count == 0) shard_count = 1;
+        shards_.reserve(shard_count);
+        for (unsigned int i = 0; i < shard_count; ++i) {
+            shards_.push_back(std::make_unique<shard>());
+        }
+    }
+
+    /**
+     * @brief Add a session, enforcing an optional session limit
+     * @param session_id The session ID
+     * @param dispatcher The session's event dispatcher
+     * @param max_sessions Maximum concurrent sessions (0 = unlimited)
+     * @return True if the session was added, false if the limit was reached
+     */
+    bool try_add_session(const std::string& session_id,
+                         std::shared_ptr<event_dispatcher> dispatcher,
+                         unsigned int max_sessions = 0) {
+        // Reserve a slot first so the limit check does not race between shards
+        size_t previous = size_.fetch_add(1, std::memory_order_acq_rel);
+        if (max_sessions > 0 && previous >= max_sessions) {
+            size_.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+
+        shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto result = s.dispatchers.emplace(session_id, std::move(dispatcher));
+        if (!result.second) {
+            // Session ID already present; keep the existing entry
+            size_.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+        s.contexts.emplace(session_id, std::make_shared<session_context>());
+        return true;
+    }
+
+    /**
+     * @brief Look up the dispatcher for a session
+     * @return The dispatcher, or nullptr if the session does not exist
+     */
+    std::shared_ptr<event_dispatcher> find_dispatcher(const std::string& session_id) const {
+        const shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.dispatchers.find(session_id);
+        return it != s.dispatchers.end() ? it->second : nullptr;
+    }
+
+    /**
+     * @brief Look up the context store for a session
+     * @return The context, or nullptr if the session does not exist
+     */
+    std::shared_ptr<session_context> find_context(const std::string& session_id) const {
+        const shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.contexts.find(session_id);
+        return it != s.contexts.end() ? it->second : nullptr;
+    }
+
+    /**
+     * @brief Check whether a session exists
+     */
+    bool contains(const std::string& session_id) const {
+        const shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.dispatchers.find(session_id) != s.dispatchers.end();
+    }
+
+    /**
+     * @brief Check whether a session has completed initialization
+     */
+    bool is_initialized(const std::string& session_id) const {
+        const shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.initialized.find(session_id);
+        return it != s.initialized.end() && it->second;
+    }
+
+    /**
+     * @brief Set the initialization state for a session
+     */
+    void set_initialized(const std::string& session_id, bool initialized) {
+        shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.initialized[session_id] = initialized;
+    }
+
+    /**
+     * @brief Remove a session and hand back its resources
+     *
+     * The dispatcher is not closed here; the caller is expected to close it
+     * outside the shard lock.
+     */
+    removed_session remove_session(const std::string& session_id) {
+        removed_session removed;
+        shard& s = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        auto dispatcher_it = s.dispatchers.find(session_id);
+        if (dispatcher_it != s.dispatchers.end()) {
+            removed.dispatcher = std::move(dispatcher_it->second);
+            s.dispatchers.erase(dispatcher_it);
+            size_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        auto context_it = s.contexts.find(session_id);
+        if (context_it != s.contexts.end()) {
+            removed.context = std::move(context_it->second);
+            s.contexts.erase(context_it);
+        }
+
+        s.initialized.erase(session_id);
+        return removed;
+    }
+
+    /**
+     * @brief Remove all sessions and hand back their resources
+     */
+    std::vector<removed_session> clear() {
+        std::vector<removed_session> removed;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            for (auto& [session_id, dispatcher] : s->dispatchers) {
+                removed_session entry;
+                entry.dispatcher = std::move(dispatcher);
+                auto context_it = s->contexts.find(session_id);
+                if (context_it != s->contexts.end()) {
+                    entry.context = std::move(context_it->second);
+                }
+                removed.push_back(std::move(entry));
+            }
+            size_.fetch_sub(s->dispatchers.size(), std::memory_order_acq_rel);
+            s->dispatchers.clear();
+            s->contexts.clear();
+            s->initialized.clear();
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Current number of sessions
+     */
+    size_t session_count() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Collect the IDs of all initialized sessions
+     */
+    std::vector<std::string> initialized_sessions() const {
+        std::vector<std::string> sessions;
+        for (const auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            for (const auto& [session_id, initialized] : s->initialized) {
+                if (initialized) {
+                    sessions.push_back(session_id);
+                }
+            }
+        }
+        return sessions;
+    }
+
+    /**
+     * @brief Schedule a session for an expiry check at the given time
+     *
+     * Entries are bucketed by the second they come due, so the maintenance
+     * sweep only touches buckets whose deadline has passed. Activity updates
+     * do not reinsert the session; instead collect_expired() re-checks the
+     * actual last-activity time when a bucket comes due and re-arms sessions
+     * that turned out to still be active. Stale entries for sessions that
+     * were removed in the meantime are simply dropped during the sweep.
+     */
+    void arm_expiry(const std::string& session_id, std::chrono::steady_clock::time_point due) {
+        const int64_t due_sec = std::chrono::duration_cast<std::chrono::seconds>(
+            due.time_since_epoch()).count();
+        std::lock_guard<std::mutex> lock(wheel_mutex_);
+        wheel_[due_sec].push_back(session_id);
+    }
+
+    /**
+     * @brief Pop due expiry buckets and return the sessions that really expired
+     * @param timeout The idle timeout
+     * @param last_activity_of Callback returning a session's last activity
+     *        time, or steady_clock::time_point::min() if the session no
+     *        longer exists
+     *
+     * The wheel lock is only held while splicing due buckets out and while
+     * re-arming individual entries, never across the activity checks, so the
+     * sweep stays incremental regardless of how many sessions exist.
+     */
+    std::vector<std::string> collect_expired(
+        std::chrono::seconds timeout,
+        const std::function<std::chrono::steady_clock::time_point(const std::string&)>& last_activity_of) {
+        const auto now = std::chrono::steady_clock::now();
+        const int64_t now_sec = std::chrono::duration_cast<std::chrono::seconds>(
+            now.time_since_epoch()).count();
+
+        std::vector<std::string> due;
+        {
+            std::lock_guard<std::mutex> lock(wheel_mutex_);
+            auto end = wheel_.upper_bound(now_sec);
+            for (auto it = wheel_.begin(); it != end; ++it) {
+                due.insert(due.end(),
+                           std::make_move_iterator(it->second.begin()),
+                           std::make_move_iterator(it->second.end()));
+            }
+            wheel_.erase(wheel_.begin(), end);
+        }
+
+        std::vector<std::string> expired;
+        for (auto& session_id : due) {
+            const auto last = last_activity_of(session_id);
+            if (last == std::chrono::steady_clock::time_point::min()) {
+                continue; // session already removed
+            }
+            if (now - last >= timeout) {
+                expired.push_back(std::move(session_id));
+            } else {
+                // Still active; re-arm at the time it would expire if it
+                // went idle right after its last recorded activity
+                arm_expiry(session_id, last + timeout);
+            }
+        }
+        return expired;
+    }
+
+    /**
+     * @brief Visit every session's dispatcher
+     *
+     * The callback is invoked while the shard lock is held, so it must be
+     * short and must not call back into the registry.
+     */
+    void for_each_dispatcher(
+        const std::function<void(const std::string&, const std::shared_ptr<event_dispatcher>&)>& fn) const {
+        for (const auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            for (const auto& [session_id, dispatcher] : s->dispatchers) {
+                fn(session_id, dispatcher);
+            }
+        }
+    }
+
+private:
+    struct shard {
+        mutable std::mutex mutex;
+        std::map<std::string, std::shared_ptr<event_dispatcher>> dispatchers;
+        std::map<std::string, std::shared_ptr<session_context>> contexts;
+        std::map<std::string, bool> initialized;
+    };
+
+    shard& shard_for(const std::string& session_id) const {
+        return *shards_[std::hash<std::string>{}(session_id) % shards_.size()];
+    }
+
+    std::vector<std::unique_ptr<shard>> shards_;
+    std::atomic<size_t> size_{0};
+
+    // Expiry wheel: due-second -> sessions to check at that second
+    std::mutex wheel_mutex_;
+    std::map<int64_t, std::vector<std::string>> wheel_;
+};
+
+} // namespace mcp
+
+#endif // MCP_SESSION_REGISTRY_H
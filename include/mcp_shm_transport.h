@@ -0,0 +1,98 @@
+/**
+ * @file mcp_shm_transport.h
+ * @brief Shared-memory message channel for co-located stdio transports
+ *
+ * This file implements an optional fast path for client and server processes
+ * running on the same host: a POSIX shared-memory segment holding a pair of
+ * single-producer single-consumer ring buffers (one per direction) carrying
+ * length-prefixed JSON-RPC frames, with process-shared condition variables as
+ * doorbells. The channel is negotiated at initialize time through the
+ * experimental capabilities object and both sides fall back to the pipe
+ * transport when creation or negotiation fails, so it is never required for
+ * correctness. Not available on Windows.
+ */
+
+#ifndef MCP_SHM_TRANSPORT_H
+#define MCP_SHM_TRANSPORT_H
+
+#if !defined(_WIN32)
+#define MCP_SHM_TRANSPORT_AVAILABLE 1
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mcp {
+
+namespace detail {
+struct shm_segment;
+}
+
+/**
+ * @class shm_channel
+ * @brief Bidirectional shared-memory frame channel between two processes
+ *
+ * The creating side (the client) owns the segment name and unlinks it on
+ * destruction; the opening side (the server) only maps it. Each direction is
+ * an SPSC byte ring, so no locking is needed on the data path: writers spin
+ * briefly and then sleep on the ring's process-shared condition variable when
+ * the ring is full, and readers do the same when it is empty.
+ */
+class shm_channel {
+public:
+    /** Per-direction ring capacity in bytes */
+    static constexpr size_t default_ring_capacity = 1 << 20;
+
+    /**
+     * @brief Create a new channel segment (client side)
+     * @return The channel, or nullptr if shared memory is unavailable
+     */
+    static std::unique_ptr<shm_channel> create(size_t ring_capacity = default_ring_capacity);
+
+    /**
+     * @brief Map an existing channel segment by name (server side)
+     * @return The channel, or nullptr if the segment cannot be mapped
+     */
+    static std::unique_ptr<shm_channel> open(const std::string& name);
+
+    ~shm_channel();
+
+    shm_channel(const shm_channel&) = delete;
+    shm_channel& operator=(const shm_channel&) = delete;
+
+    /**
+     * @brief Write one frame into the outbound ring, blocking while full
+     * @return False if the channel is closed or the frame can never fit
+     *         (oversized frames should go over the pipe instead)
+     */
+    bool write_frame(const std::string& payload);
+
+    /**
+     * @brief Read one frame from the inbound ring
+     * @return False on timeout or when the channel is closed and drained
+     */
+    bool read_frame(std::string& payload, std::chrono::milliseconds timeout);
+
+    /** Close the channel and wake both sides */
+    void close();
+
+    bool is_closed() const;
+
+    /** Segment name, passed to the peer during negotiation */
+    const std::string& name() const { return name_; }
+
+private:
+    shm_channel(std::string name, bool owner, detail::shm_segment* segment, size_t mapped_size);
+
+    std::string name_;
+    bool owner_;
+    detail::shm_segment* segment_;
+    size_t mapped_size_;
+};
+
+} // namespace mcp
+
+#endif // !defined(_WIN32)
+
+#endif // MCP_SHM_TRANSPORT_H
@@ -17,6 +17,7 @@
 // Include the HTTP library
 #include "httplib.h"
 
+#include <array>
 #include <string>
 #include <map>
 #include <vector>
@@ -87,6 +88,16 @@ public:
      */
     void set_timeout(int timeout_seconds);
 
+    /**
+     * @brief Set the number of pooled connections for the message endpoint
+     * @param size Maximum number of concurrent keep-alive POST connections
+     *
+     * Each send_request checks a connection out of the pool for the duration
+     * of its POST, so up to `size` requests from different threads proceed
+     * in parallel over established sockets. Defaults to 4.
+     */
+    void set_connection_pool_size(size_t size);
+
     /**
      * @brief Set client capabilities
      * @param capabilities The capabilities of the client
@@ -172,6 +183,17 @@ public:
      */
     bool is_running() const override;
 
+    /**
+     * @brief Number of requests currently awaiting their SSE response
+     * @return The in-flight request count
+     *
+     * Intended for caller-side backpressure: pipelining callers can hold
+     * off on new requests once this crosses their own threshold.
+     */
+    size_t in_flight_requests() const {
+        return in_flight_.load(std::memory_order_relaxed);
+    }
+
 private:
     // Initialize HTTP client
     void init_client(const std::string& scheme_host_port, bool validate_certificates, const std::string& ca_cert_path);
@@ -187,7 +209,17 @@ private:
     
     // Send JSON-RPC request
     json send_jsonrpc(const request& req);
-    
+
+    // Create a keep-alive client for the message endpoint with the
+    // current timeout, header and TLS settings applied
+    std::unique_ptr<httplib::Client> create_post_client();
+
+    // Check a POST connection out of the pool (blocks when all are in use)
+    std::unique_ptr<httplib::Client> acquire_post_client();
+
+    // Return a POST connection to the pool
+    void release_post_client(std::unique_ptr<httplib::Client> client);
+
     // Server host and port
     std::string host_;
     int port_ = 8080;
@@ -201,9 +233,17 @@ private:
     // Message endpoint
     std::string msg_endpoint_;
     
-    // HTTP client
-    std::unique_ptr<httplib::Client> http_client_;
-    
+    // Pool of keep-alive POST connections for the message endpoint
+    std::vector<std::unique_ptr<httplib::Client>> idle_post_clients_;
+    size_t post_pool_capacity_ = 4;
+    size_t post_clients_created_ = 0;
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+
+    // TLS settings, kept for clients created after construction
+    bool validate_certificates_ = true;
+    std::string ca_cert_path_;
+
     // SSE HTTP client
     std::unique_ptr<httplib::Client> sse_client_;
     
@@ -234,14 +274,35 @@ private:
     // Condition variable, used to wait for message endpoint setting
     std::condition_variable endpoint_cv_;
     
-    // Request ID to Promise mapping (using string key for type consistency)
-    std::map<std::string, std::promise<json>> pending_requests_;
-    
-    // Response processing mutex
-    std::mutex response_mutex_;
-    
-    // Response condition variable
-    std::condition_variable response_cv_;
+    // Pending requests, sharded by request-id hash so the SSE parser thread
+    // and concurrent callers almost never touch the same lock. Each entry's
+    // promise gives per-request wakeup — completing a response signals only
+    // its waiter, never a broadcast.
+    static constexpr size_t pending_shard_count = 16;
+
+    struct pending_shard {
+        std::mutex mutex;
+        // String key is the JSON-serialized request id, for type consistency
+        std::map<std::string, std::promise<json>> requests;
+    };
+
+    pending_shard& shard_for(const std::string& id_key) {
+        return pending_shards_[std::hash<std::string>{}(id_key) % pending_shard_count];
+    }
+
+    // Register a pending request, returning the future its response resolves
+    std::future<json> register_pending(const std::string& id_key);
+
+    // Resolve a pending request with its response; false if the id is unknown
+    bool complete_pending(const std::string& id_key, json value);
+
+    // Drop a pending request without resolving it (send failure, timeout)
+    void erase_pending(const std::string& id_key);
+
+    std::array<pending_shard, pending_shard_count> pending_shards_;
+
+    // Requests registered but not yet completed or erased
+    std::atomic<size_t> in_flight_{0};
 };
 
 } // namespace mcp
@@ -14,8 +14,10 @@
 #include "mcp_message.h"
 #include "mcp_tool.h"
 #include "mcp_logger.h"
+#include "mcp_shm_transport.h"
 
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <memory>
@@ -62,7 +64,32 @@ public:
      * @note This must be called before initialize()
      */
     void set_environment_variables(const json& env_vars);
-    
+
+    /**
+     * @brief Opt in to the shared-memory fast path for small messages
+     * @param enabled Whether to offer the channel during initialize()
+     * @param ring_capacity Per-direction ring size in bytes
+     * @note This must be called before initialize(). The channel is
+     * negotiated through capabilities.experimental.shm; if the server does
+     * not accept (or this platform has no shared-memory support) the client
+     * keeps using the pipe transport. Frames too large for the ring also
+     * fall back to the pipe transparently.
+     */
+    void set_shm_transport(bool enabled,
+                           size_t ring_capacity = 1 << 20);
+
+    /**
+     * @brief Opt in to binary length-prefixed framing over the pipe
+     * @param enabled Whether to offer the mode during initialize()
+     * @note This must be called before initialize(). Frames become a 4-byte
+     * little-endian length prefix plus a MessagePack body, so payloads may
+     * embed newlines and binary content without text escaping. Negotiated
+     * through capabilities.experimental.binary_framing; if the server does
+     * not accept, the client keeps newline-delimited JSON.
+     */
+    void set_binary_framing(bool enabled);
+
+
     /**
      * @brief Initialize the connection with the server
      * @param client_name The name of the client
@@ -91,7 +118,21 @@ public:
      * @throws mcp_exception on error
      */
     response send_request(const std::string& method, const json& params = json::object()) override;
-    
+
+    /**
+     * @brief Send a request without blocking on the response
+     * @param method The method to call
+     * @param params The parameters to pass
+     * @return Future resolving to the response
+     * @throws mcp_exception if the request cannot be written
+     *
+     * Requests are pipelined: many may be outstanding on the pipe at once
+     * and responses complete their futures in whatever order the server
+     * produces them, so a slow tool call no longer stalls other callers.
+     * The future must not outlive the client.
+     */
+    std::future<response> send_request_async(const std::string& method, const json& params = json::object());
+
     /**
      * @brief Send a notification (no response expected)
      * @param method The method to call
@@ -171,12 +212,33 @@ private:
     
     // Read thread function
     void read_thread_func();
-    
-    // Send JSON-RPC request
+
+    // Frame newline-delimited messages out of raw pipe data incrementally
+    void process_read_data(const char* data, size_t size);
+
+    // Handle one complete JSON-RPC message line from the server
+    void handle_server_message(std::string_view line);
+
+    // Route one decoded server message to its pending request (or log it)
+    void handle_server_json(const json& message);
+
+    // Send JSON-RPC request and wait for the response
     json send_jsonrpc(const request& req);
-    
+
+    // Write a JSON-RPC request, returning a future for its response;
+    // the pending entry is registered before the frame hits the pipe
+    std::future<json> send_jsonrpc_async(const request& req);
+
+    // Wait for a pending response with timeout and map errors to exceptions
+    json wait_for_response(std::future<json>& response_future, const json& id);
+
     // Server command
     std::string command_;
+
+    // Buffered pipe data not yet framed into complete lines; the consumed
+    // prefix is tracked as an offset instead of being erased per message
+    std::string read_buffer_;
+    size_t read_buffer_offset_ = 0;
     
     // Process ID
     int process_id_ = -1;
@@ -216,15 +278,38 @@ private:
     
     // Response processing mutex
     std::mutex response_mutex_;
+
+    // Serializes frame writes so pipelined requests never interleave
+    std::mutex write_mutex_;
     
     // Initialization status
     std::atomic<bool> initialized_{false};
     
     // Initialization condition variable
     std::condition_variable init_cv_;
-    
+
     // Environment variables
     json env_vars_;
+
+    // Binary length-prefixed framing (negotiated at initialize time)
+    bool binary_requested_ = false;
+    std::atomic<bool> binary_active_{false};
+
+    // Upper bound on a binary frame's declared length (matches the server);
+    // a larger prefix means the stream is corrupted or desynced
+    static constexpr uint32_t max_frame_size = 256u * 1024 * 1024;
+
+    // Shared-memory transport (negotiated at initialize time)
+    bool shm_requested_ = false;
+    size_t shm_ring_capacity_ = 1 << 20;
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    // Reads response frames from the channel, mirroring read_thread_func
+    void shm_read_thread_func();
+
+    std::unique_ptr<shm_channel> shm_;
+    std::unique_ptr<std::thread> shm_read_thread_;
+    std::atomic<bool> shm_active_{false};
+#endif
 };
 
 } // namespace mcp
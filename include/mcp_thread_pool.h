@@ -1,18 +1,28 @@
 /**
  * @file mcp_thread_pool.h
- * @brief Dynamic thread pool implementation
+ * @brief Dynamic thread pool with work-stealing task queues
+ *
+ * Tasks are distributed round-robin across per-worker deques, each guarded by
+ * its own small mutex, instead of funnelling through one global queue. Workers
+ * pop their own queue LIFO for cache locality and steal FIFO from other queues
+ * when empty, so the submission path and the execution path rarely touch the
+ * same lock. Wakeups are batched: a submitter only signals when at least one
+ * worker is actually sleeping, avoiding the notify storm of the previous
+ * single-queue design.
  */
 
 #ifndef MCP_THREAD_POOL_H
 #define MCP_THREAD_POOL_H
 
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
+#include <vector>
 #include <type_traits>
 #include <chrono>
 #include <stdexcept>
@@ -23,44 +33,50 @@ class thread_pool {
 public:
     /**
      * @brief Constructor for dynamic thread pool
-     * @param min_threads Minimum number of threads (core threads)
-     * @param max_threads Maximum number of threads
-     * @param idle_timeout_ms Idle time in milliseconds before a thread exits
+     * @param min_threads Minimum number of threads (core threads, each owning a task queue)
+     * @param max_threads Maximum number of threads (extra threads are pure stealers)
+     * @param idle_timeout_ms Idle time in milliseconds before a surge thread exits
      */
     explicit thread_pool(
-        size_t min_threads = (std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2), 
+        size_t min_threads = (std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2),
         size_t max_threads = (std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() * 4 : 16),
-        size_t idle_timeout_ms = 60000) 
-        : min_threads_(min_threads), 
-          max_threads_(max_threads), 
-          idle_timeout_(idle_timeout_ms), 
+        size_t idle_timeout_ms = 60000)
+        : min_threads_(min_threads),
+          max_threads_(max_threads),
+          idle_timeout_(idle_timeout_ms),
           stop_(false) {
-        
+
         if (min_threads_ == 0) min_threads_ = 1;
         if (max_threads_ < min_threads_) max_threads_ = min_threads_;
 
+        // One task queue per core worker; surge workers steal from these
+        queues_.reserve(min_threads_);
+        for (size_t i = 0; i < min_threads_; ++i) {
+            queues_.push_back(std::make_unique<task_queue>());
+        }
+
         // Start core threads
         for (size_t i = 0; i < min_threads_; ++i) {
-            spawn_thread();
+            spawn_thread(i);
         }
     }
-    
+
     /**
      * @brief Destructor
      */
     ~thread_pool() {
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
             stop_ = true;
         }
-        
+
         condition_.notify_all();
-        
+
         // Wait for all detached threads to cleanly exit
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
         shutdown_cv_.wait(lock, [this] { return active_threads_ == 0; });
     }
-    
+
     /**
      * @brief Submit task to thread pool
      * @param f Task function
@@ -70,106 +86,157 @@ public:
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
         using return_type = typename std::invoke_result<F, Args...>::type;
-        
+
         auto task = std::make_shared<std::packaged_task<return_type()>>(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...)
         );
-        
+
         std::future<return_type> result = task->get_future();
-        
+
+        if (stop_.load(std::memory_order_acquire)) {
+            throw std::runtime_error("Thread pool stopped, cannot add task");
+        }
+
+        // Round-robin over the per-worker queues; each push touches only
+        // that queue's mutex, so submitters rarely contend with each other
+        size_t index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            
-            if (stop_) {
-                throw std::runtime_error("Thread pool stopped, cannot add task");
-            }
-            
-            tasks_.emplace([task]() { (*task)(); });
-            
-            // Auto-expansion logic:
-            // If there are no idle threads available to pick up this new task, 
-            // and we haven't reached the maximum allowed threads, spawn a new one.
-            if (idle_threads_ == 0 && active_threads_ < max_threads_) {
-                spawn_thread();
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.emplace_back([task]() { (*task)(); });
+        }
+        pending_tasks_.fetch_add(1, std::memory_order_release);
+
+        // Batched wakeup: only signal when a worker is actually sleeping
+        if (idle_threads_.load(std::memory_order_acquire) > 0) {
+            condition_.notify_one();
+        } else if (active_threads_.load() < max_threads_) {
+            // Everyone is busy; spawn a surge thread that steals from the
+            // core queues until it idles out
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            if (idle_threads_.load(std::memory_order_acquire) == 0 &&
+                active_threads_.load() < max_threads_ && !stop_) {
+                spawn_thread(queues_.size());
             }
         }
-        
-        condition_.notify_one();
+
         return result;
     }
 
     /**
      * @brief Get current number of active threads (for monitoring)
      */
-    size_t get_active_threads() const { 
-        return active_threads_.load(); 
+    size_t get_active_threads() const {
+        return active_threads_.load();
     }
-    
+
+    /**
+     * @brief Get current number of queued (not yet started) tasks
+     */
+    size_t get_queue_depth() const {
+        return pending_tasks_.load(std::memory_order_acquire);
+    }
+
 private:
-    void spawn_thread() {
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void spawn_thread(size_t home_queue) {
         active_threads_++;
-        std::thread([this]() {
-            worker_loop();
+        std::thread([this, home_queue]() {
+            worker_loop(home_queue);
         }).detach();
     }
 
-    void worker_loop() {
-        bool is_shrinking = false;
+    // Pop from the worker's own queue (LIFO for locality)
+    bool pop_local(size_t home_queue, std::function<void()>& task) {
+        if (home_queue >= queues_.size()) {
+            return false; // Surge workers have no home queue
+        }
+        task_queue& q = *queues_[home_queue];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    // Steal from another worker's queue (FIFO, oldest task first)
+    bool steal(size_t home_queue, std::function<void()>& task) {
+        for (size_t offset = 1; offset <= queues_.size(); ++offset) {
+            size_t victim = (home_queue + offset) % queues_.size();
+            task_queue& q = *queues_[victim];
+            // try_lock: skip a contended victim instead of waiting on it
+            std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                continue;
+            }
+            if (q.tasks.empty()) {
+                continue;
+            }
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    bool try_get_task(size_t home_queue, std::function<void()>& task) {
+        if (pending_tasks_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        if (pop_local(home_queue, task) || steal(home_queue, task)) {
+            pending_tasks_.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop(size_t home_queue) {
         while (true) {
             std::function<void()> task;
-            
+
+            if (try_get_task(home_queue, task)) {
+                // Execute the task without holding any lock
+                task();
+                continue;
+            }
+
+            // Nothing to run anywhere; go to sleep
+            bool is_timeout = false;
             {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+
                 idle_threads_++;
-                
-                // Wait for tasks or idle timeout
-                bool is_timeout = !condition_.wait_for(lock, idle_timeout_, [this] { 
-                    return stop_ || !tasks_.empty(); 
+
+                is_timeout = !condition_.wait_for(lock, idle_timeout_, [this] {
+                    return stop_ || pending_tasks_.load(std::memory_order_acquire) > 0;
                 });
-                
+
                 idle_threads_--;
-                
-                // Exit condition 1: Destructor called and queue is empty
-                if (stop_ && tasks_.empty()) {
-                    is_shrinking = true;
-                    active_threads_--;
-                    break;
-                }
-                
-                // Exit condition 2: Thread timed out, queue is empty, and we can shrink
-                if (is_timeout && tasks_.empty() && active_threads_ > min_threads_) {
-                    is_shrinking = true;
-                    active_threads_--;
-                    break;
-                }
-
-                // Handle spurious wakeups
-                if (tasks_.empty()) {
-                    continue;
-                }
-                
-                task = std::move(tasks_.front());
-                tasks_.pop();
             }
-            
-            // Execute the task without holding the lock
-            task();
+
+            // Exit condition 1: Destructor called and all queues are drained
+            if (stop_ && pending_tasks_.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+
+            // Exit condition 2: Thread timed out with nothing queued, and we can shrink
+            if (is_timeout && pending_tasks_.load(std::memory_order_acquire) == 0 &&
+                active_threads_ > min_threads_) {
+                break;
+            }
         }
-        
+
         // Thread is terminating, update counts and notify destructor if needed
         {
-            if (is_shrinking) {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                if (active_threads_ == 0) {
-                    shutdown_cv_.notify_all();
-                }
-            } else {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                active_threads_--;
-                if (active_threads_ == 0) {
-                    shutdown_cv_.notify_all();
-                }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            active_threads_--;
+            if (active_threads_ == 0) {
+                shutdown_cv_.notify_all();
             }
         }
     }
@@ -177,19 +244,22 @@ private:
     size_t min_threads_;
     size_t max_threads_;
     std::chrono::milliseconds idle_timeout_;
-    
+
     std::atomic<size_t> active_threads_{0};
-    size_t idle_threads_{0}; // protected by queue_mutex_
-    
-    std::queue<std::function<void()>> tasks_;
-    
-    std::mutex queue_mutex_;
+    std::atomic<size_t> idle_threads_{0};
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<size_t> next_queue_{0};
+
+    // Per-worker task queues (fixed at construction; surge workers only steal)
+    std::vector<std::unique_ptr<task_queue>> queues_;
+
+    std::mutex sleep_mutex_;
     std::condition_variable condition_;
     std::condition_variable shutdown_cv_;
-    
-    bool stop_;
+
+    std::atomic<bool> stop_;
 };
 
 } // namespace mcp
 
-#endif // MCP_THREAD_POOL_H
\ No newline at end of file
+#endif // MCP_THREAD_POOL_H
@@ -9,8 +9,12 @@
 #define MCP_TOOL_H
 
 #include "mcp_message.h"
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <map>
 #include <memory>
@@ -181,6 +185,88 @@ inline tool create_tool(
     return builder.build();
 }
 
+/**
+ * @struct tool_param_traits
+ * @brief Maps a C++ parameter type to its JSON schema type name
+ *
+ * Used by the typed tool registration API (server::register_tool_typed) to
+ * generate the input schema from the handler's parameter list at compile
+ * time. Add a specialization to support further types.
+ */
+template<typename T>
+struct tool_param_traits;
+
+template<> struct tool_param_traits<std::string> { static constexpr const char* type_name = "string"; };
+template<> struct tool_param_traits<bool>        { static constexpr const char* type_name = "boolean"; };
+template<> struct tool_param_traits<int>         { static constexpr const char* type_name = "integer"; };
+template<> struct tool_param_traits<std::int64_t>{ static constexpr const char* type_name = "integer"; };
+template<> struct tool_param_traits<double>      { static constexpr const char* type_name = "number"; };
+template<> struct tool_param_traits<json>        { static constexpr const char* type_name = "object"; };
+
+/**
+ * @brief Build a tool whose input schema is derived from a type list
+ * @tparam Args The handler's parameter types, in order
+ * @param param_names One name per parameter, in the same order
+ *
+ * All parameters are required; the schema type for each comes from
+ * tool_param_traits.
+ */
+template<typename... Args>
+tool build_typed_tool(const std::string& name, const std::string& description,
+                      const std::array<std::string, sizeof...(Args)>& param_names) {
+    const std::array<const char*, sizeof...(Args)> type_names{
+        tool_param_traits<std::decay_t<Args>>::type_name...};
+
+    json properties = json::object();
+    json required = json::array();
+    for (size_t i = 0; i < param_names.size(); ++i) {
+        properties[param_names[i]] = {{"type", type_names[i]}};
+        required.push_back(param_names[i]);
+    }
+
+    tool t;
+    t.name = name;
+    t.description = description;
+    t.parameters_schema = {
+        {"type", "object"},
+        {"properties", properties},
+        {"required", required}
+    };
+    return t;
+}
+
+/**
+ * @brief Extract one typed parameter from a tool's arguments object
+ * @throws mcp_exception with invalid_params when the key is missing or the
+ *         value does not convert to T
+ */
+template<typename T>
+T extract_tool_param(const json& arguments, const std::string& name) {
+    auto it = arguments.find(name);
+    if (it == arguments.end()) {
+        throw mcp_exception(error_code::invalid_params, "Missing required parameter: " + name);
+    }
+    try {
+        return it->get<T>();
+    } catch (const json::exception&) {
+        throw mcp_exception(error_code::invalid_params, "Invalid type for parameter: " + name);
+    }
+}
+
+/**
+ * @brief Call a typed handler with parameters pulled from the arguments object
+ *
+ * Each parameter is looked up and converted exactly once, directly into the
+ * handler's argument list, so handler bodies work with native types instead
+ * of repeating params["x"].get<T>() per use.
+ */
+template<typename... Args, typename F, size_t... I>
+json invoke_typed_tool(F& handler, const std::array<std::string, sizeof...(Args)>& param_names,
+                       const json& arguments, const std::string& session_id,
+                       std::index_sequence<I...>) {
+    return handler(extract_tool_param<std::decay_t<Args>>(arguments, param_names[I])..., session_id);
+}
+
 } // namespace mcp
 
 #endif // MCP_TOOL_H
\ No newline at end of file
@@ -13,8 +13,15 @@
 #include <stdexcept>
 #include <chrono>
 #include <ctime>
+#include <cstring>
 #include <mutex>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace mcp {
@@ -93,7 +100,7 @@ json binary_resource::read() const {
     return {
         {"uri", uri_},
         {"mimeType", mime_type_},
-        {"blob", base64_data}
+        {"blob", std::move(base64_data)}
     };
 }
 
@@ -213,6 +220,174 @@ std::string file_resource::guess_mime_type(const std::string& file_path) {
     return "application/octet-stream";
 }
 
+// mmap_file_resource implementation
+mmap_file_resource::mmap_file_resource(const std::string& file_path,
+                                       const std::string& mime_type,
+                                       const std::string& description)
+    : file_path_(file_path),
+      uri_("file://" + file_path),
+      name_(fs::path(file_path).filename().string()),
+      mime_type_(mime_type.empty() ? file_resource::guess_mime_type(file_path) : mime_type),
+      description_(description) {
+
+    // Check if file exists
+    if (!fs::exists(file_path_)) {
+        throw mcp_exception(error_code::invalid_params,
+                           "File not found: " + file_path_);
+    }
+}
+
+mmap_file_resource::~mmap_file_resource() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap();
+}
+
+json mmap_file_resource::get_metadata() const {
+    return {
+        {"uri", uri_},
+        {"name", name_},
+        {"mimeType", mime_type_},
+        {"description", description_}
+    };
+}
+
+void mmap_file_resource::unmap() const {
+#ifndef _WIN32
+    if (mapped_ && data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    fallback_.clear();
+    fallback_.shrink_to_fit();
+}
+
+void mmap_file_resource::refresh_mapping() const {
+    if (!fs::exists(file_path_)) {
+        throw mcp_exception(error_code::internal_error,
+                           "File not found: " + file_path_);
+    }
+
+    time_t mtime = fs::last_write_time(file_path_).time_since_epoch().count();
+    uintmax_t file_size = fs::file_size(file_path_);
+
+    if (data_ != nullptr && mtime == mapped_mtime_ && file_size == mapped_file_size_) {
+        return; // mapping is current
+    }
+
+    unmap();
+    full_cache_valid_ = false;
+
+#ifndef _WIN32
+    if (file_size > 0) {
+        int fd = ::open(file_path_.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            void* addr = ::mmap(nullptr, static_cast<size_t>(file_size),
+                                PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (addr != MAP_FAILED) {
+                data_ = static_cast<const char*>(addr);
+                size_ = static_cast<size_t>(file_size);
+                mapped_ = true;
+                mapped_mtime_ = mtime;
+                mapped_file_size_ = file_size;
+                return;
+            }
+        }
+    }
+#endif
+
+    // Streaming fallback (Windows, mmap failure, or empty file)
+    std::ifstream file(file_path_, std::ios::binary);
+    if (!file) {
+        throw mcp_exception(error_code::internal_error,
+                           "Failed to open file: " + file_path_);
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    mapped_ = false;
+    mapped_mtime_ = mtime;
+    mapped_file_size_ = file_size;
+}
+
+bool mmap_file_resource::is_text_mime() const {
+    if (mime_type_.compare(0, 5, "text/") == 0) {
+        return true;
+    }
+    return mime_type_ == "application/json" ||
+           mime_type_ == "application/xml" ||
+           mime_type_ == "application/javascript" ||
+           mime_type_ == "image/svg+xml";
+}
+
+json mmap_file_resource::read() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_mapping();
+
+    if (!full_cache_valid_) {
+        if (is_text_mime()) {
+            full_cache_ = {
+                {"uri", uri_},
+                {"mimeType", mime_type_},
+                {"text", std::string(data_, size_)}
+            };
+        } else {
+            full_cache_ = {
+                {"uri", uri_},
+                {"mimeType", mime_type_},
+                {"blob", base64::encode(data_, size_)}
+            };
+        }
+        full_cache_valid_ = true;
+    }
+
+    served_mtime_ = mapped_mtime_;
+    return full_cache_;
+}
+
+json mmap_file_resource::read_range(size_t offset, size_t length) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_mapping();
+
+    if (offset > size_) {
+        throw mcp_exception(error_code::invalid_params,
+                           "Range offset past end of resource: " + uri_);
+    }
+
+    size_t count = std::min(length, size_ - offset);
+    served_mtime_ = mapped_mtime_;
+
+    if (is_text_mime()) {
+        return {
+            {"uri", uri_},
+            {"mimeType", mime_type_},
+            {"text", std::string(data_ + offset, count)}
+        };
+    }
+    return {
+        {"uri", uri_},
+        {"mimeType", mime_type_},
+        {"blob", base64::encode(data_ + offset, count)}
+    };
+}
+
+bool mmap_file_resource::is_modified() const {
+    if (!fs::exists(file_path_)) {
+        return true; // File was deleted
+    }
+
+    time_t current_modified = fs::last_write_time(file_path_).time_since_epoch().count();
+    return current_modified != served_mtime_;
+}
+
+std::string mmap_file_resource::get_uri() const {
+    return uri_;
+}
+
 // resource_manager implementation
 static std::mutex g_resource_manager_mutex;
 
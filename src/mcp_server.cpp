@@ -7,13 +7,71 @@
  */
 
 #include "mcp_server.h"
+#include "mcp_json_scan.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace {
 bool file_exists(const std::string& path) {
     struct stat st;
     return ::stat(path.c_str(), &st) == 0;
 }
+
+// Registry snapshot file layout: header followed by a MessagePack payload
+constexpr uint32_t registry_snapshot_magic = 0x4d435253; // "MCRS"
+constexpr uint32_t registry_snapshot_version = 1;
+
+struct registry_snapshot_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t payload_size;
+    uint64_t payload_hash;
+};
+
+// FNV-1a over the payload; cheap enough to run on every load and catches
+// truncated or corrupted snapshot files before they reach the registries
+// Length prefix for negotiated binary framing: 4 bytes, little-endian on
+// the wire regardless of host byte order
+void frame_put_le32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value & 0xff);
+    out[1] = static_cast<char>((value >> 8) & 0xff);
+    out[2] = static_cast<char>((value >> 16) & 0xff);
+    out[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+uint32_t frame_get_le32(const char* in) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(in[0])) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[1])) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[2])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[3])) << 24);
+}
+
+uint64_t fnv1a_hash(const uint8_t* data, size_t size) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
 } // anonymous namespace
 
 namespace mcp {
@@ -27,10 +85,13 @@ server::server(const server::configuration& conf)
     , sse_endpoint_(conf.sse_endpoint)
     , msg_endpoint_(conf.msg_endpoint)
     , mcp_endpoint_(conf.mcp_endpoint)
+    , metrics_endpoint_(conf.metrics_endpoint)
+    , sessions_(conf.session_shards)
     , thread_pool_(conf.threadpool_size)
     , max_sessions_(conf.max_sessions)
     , session_timeout_(conf.session_timeout)
 {
+    notification_coalesce_ms_ = conf.notification_coalesce_ms;
     #ifdef MCP_SSL
     if (conf.ssl.server_cert_path && conf.ssl.server_private_key_path) {
         if (!file_exists(*conf.ssl.server_cert_path)) {
@@ -57,66 +118,459 @@ server::~server() {
 
 void server::start_stdio() {
     running_ = true;
-    std::string line;
     std::string session_id = "stdio_session_" + std::to_string(std::time(nullptr));
-    
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) continue;
-        try {
-            json req_json = json::parse(line);
-            request req;
-            
-            if (req_json.is_object() && req_json.contains("jsonrpc") && req_json["jsonrpc"] == "2.0") {
-                req.jsonrpc = "2.0";
-                if (req_json.contains("id")) {
-                    req.id = req_json["id"];
-                } else {
-                    req.id = nullptr;
+    // Register the session so handlers get a session context; the dispatcher
+    // is unused on this transport
+    sessions_.try_add_session(session_id, std::make_shared<event_dispatcher>());
+#ifdef __linux__
+    // The epoll engine reads file descriptor 0 directly, bypassing std::cin.
+    // That is only safe when stdin is the pipe or socket a spawning client
+    // handed us; terminals and redirected streams (tests swap the rdbuf of
+    // std::cin) go through the portable stream-based engine instead.
+    struct stat stdin_stat {};
+    if (::fstat(0, &stdin_stat) == 0 &&
+        (S_ISFIFO(stdin_stat.st_mode) || S_ISSOCK(stdin_stat.st_mode))) {
+        run_stdio_epoll(session_id);
+    } else {
+        run_stdio_portable(session_id);
+    }
+#else
+    run_stdio_portable(session_id);
+#endif
+    close_session(session_id);
+    running_ = false;
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    shutdown_shm_channels();
+#endif
+}
+
+json server::dispatch_stdio_json(const json& req_json, const std::string& session_id) {
+    if (req_json.is_object() && req_json.contains("jsonrpc") && req_json["jsonrpc"] == "2.0") {
+        request req;
+        req.jsonrpc = "2.0";
+        if (req_json.contains("id")) {
+            req.id = req_json["id"];
+        } else {
+            req.id = nullptr;
+        }
+        req.method = req_json.value("method", "");
+        if (req_json.contains("params")) {
+            req.params = req_json["params"];
+        }
+
+        json res = process_request(req, session_id);
+        if (req.method == "initialize" && res.contains("result")) {
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+            try_accept_shm_offer(req.params, res["result"], session_id);
+#endif
+            try_accept_binary_framing(req.params, res["result"]);
+        }
+        return res;
+    }
+
+    json err_res = {
+        {"jsonrpc", "2.0"},
+        {"error", {
+            {"code", static_cast<int>(error_code::invalid_request)},
+            {"message", "Invalid JSON-RPC format"}
+        }}
+    };
+    if (req_json.contains("id")) {
+        err_res["id"] = req_json["id"];
+    } else {
+        err_res["id"] = nullptr;
+    }
+    return err_res;
+}
+
+std::string server::handle_stdio_message(const std::string& line, const std::string& session_id) {
+    try {
+        json res = dispatch_stdio_json(json::parse(line), session_id);
+        if (res.is_null()) {
+            return std::string();
+        }
+        return res.dump() + "\n";
+    } catch (const std::exception& e) {
+        json err_res = {
+            {"jsonrpc", "2.0"},
+            {"error", {
+                {"code", static_cast<int>(error_code::parse_error)},
+                {"message", std::string("Parse error: ") + e.what()}
+            }},
+            {"id", nullptr}
+        };
+        return err_res.dump() + "\n";
+    }
+}
+
+std::string server::handle_stdio_binary_frame(const std::string& frame, const std::string& session_id) {
+    json res;
+    try {
+        res = dispatch_stdio_json(json::from_msgpack(frame), session_id);
+    } catch (const std::exception& e) {
+        res = {
+            {"jsonrpc", "2.0"},
+            {"error", {
+                {"code", static_cast<int>(error_code::parse_error)},
+                {"message", std::string("Parse error: ") + e.what()}
+            }},
+            {"id", nullptr}
+        };
+    }
+    // Notifications produce an empty object from process_request; unlike
+    // the text path there is no point framing it, so nothing goes out
+    if (res.is_null() || (res.is_object() && res.empty())) {
+        return std::string();
+    }
+
+    std::vector<uint8_t> body = json::to_msgpack(res);
+    uint32_t length = static_cast<uint32_t>(body.size());
+    std::string out(sizeof(length) + body.size(), '\0');
+    frame_put_le32(&out[0], length);
+    std::memcpy(&out[sizeof(length)], body.data(), body.size());
+    return out;
+}
+
+void server::try_accept_binary_framing(const json& params, json& result) {
+    if (!params.contains("capabilities")) return;
+    const json& caps = params["capabilities"];
+    if (!caps.contains("experimental") || !caps["experimental"].contains("binary_framing")) return;
+    const json& offer = caps["experimental"]["binary_framing"];
+    if (offer.value("encoding", "msgpack") != "msgpack") {
+        return;  // only MessagePack bodies are supported
+    }
+
+    result["capabilities"]["experimental"]["binary_framing"] = {
+        {"accepted", true},
+        {"encoding", "msgpack"}
+    };
+    // The initialize response itself still goes out newline-framed; the
+    // client switches after reading it, so every later inbound frame is
+    // length-prefixed
+    stdio_binary_.store(true, std::memory_order_release);
+    LOG_INFO("Binary stdio framing accepted (msgpack)");
+}
+
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+void server::try_accept_shm_offer(const json& params, json& result, const std::string& session_id) {
+    if (!params.contains("capabilities")) return;
+    const json& caps = params["capabilities"];
+    if (!caps.contains("experimental") || !caps["experimental"].contains("shm")) return;
+    const json& offer = caps["experimental"]["shm"];
+    if (!offer.contains("name") || !offer["name"].is_string()) return;
+
+    auto channel = shm_channel::open(offer["name"].get<std::string>());
+    if (!channel) {
+        LOG_WARNING("Rejecting shared-memory offer, segment could not be mapped");
+        return;
+    }
+
+    std::shared_ptr<shm_channel> shared(std::move(channel));
+    std::thread service([this, shared, session_id]() {
+        run_shm_channel(shared, session_id);
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(shm_mutex_);
+        shm_channels_.emplace_back(shared, std::move(service));
+    }
+
+    result["capabilities"]["experimental"]["shm"] = {{"accepted", true}};
+    LOG_INFO("Shared-memory channel accepted: ", shared->name());
+}
+
+void server::run_shm_channel(std::shared_ptr<shm_channel> channel, const std::string& session_id) {
+    std::string frame;
+    while (running_ && !channel->is_closed()) {
+        if (!channel->read_frame(frame, std::chrono::milliseconds(100))) {
+            continue;
+        }
+        std::string out = handle_stdio_message(frame, session_id);
+        if (!out.empty()) {
+            if (out.back() == '\n') {
+                out.pop_back();
+            }
+            channel->write_frame(out);
+        }
+    }
+}
+
+void server::shutdown_shm_channels() {
+    std::vector<std::pair<std::shared_ptr<shm_channel>, std::thread>> channels;
+    {
+        std::lock_guard<std::mutex> lock(shm_mutex_);
+        channels.swap(shm_channels_);
+    }
+    for (auto& [channel, thread] : channels) {
+        channel->close();
+    }
+    for (auto& [channel, thread] : channels) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+#endif // MCP_SHM_TRANSPORT_AVAILABLE
+
+void server::run_stdio_portable(const std::string& session_id) {
+    std::string line;
+    for (;;) {
+        if (!stdio_binary_.load(std::memory_order_acquire)) {
+            if (!std::getline(std::cin, line)) break;
+            if (line.empty()) continue;
+            std::string out = handle_stdio_message(line, session_id);
+            if (!out.empty()) {
+                std::cout << out << std::flush;
+            }
+        } else {
+            char header[sizeof(uint32_t)];
+            if (!std::cin.read(header, sizeof(header))) break;
+            uint32_t length = frame_get_le32(header);
+            if (length > max_stdio_frame_size) {
+                LOG_ERROR("stdio: oversized binary frame (", length, " bytes), closing");
+                break;
+            }
+            std::string frame(length, '\0');
+            if (length > 0 && !std::cin.read(&frame[0], length)) break;
+            std::string out = handle_stdio_binary_frame(frame, session_id);
+            if (!out.empty()) {
+                std::cout << out << std::flush;
+            }
+        }
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+// Write a batch of response lines with as few writev calls as possible,
+// resuming correctly after partial writes
+void write_all_iovec(int fd, std::vector<std::string>& chunks) {
+    constexpr int max_iov = 64;
+    size_t idx = 0;
+    size_t skip = 0;
+
+    while (idx < chunks.size()) {
+        iovec iov[max_iov];
+        int cnt = 0;
+        for (size_t i = idx; i < chunks.size() && cnt < max_iov; ++i, ++cnt) {
+            size_t offset = (i == idx) ? skip : 0;
+            iov[cnt].iov_base = const_cast<char*>(chunks[i].data()) + offset;
+            iov[cnt].iov_len = chunks[i].size() - offset;
+        }
+
+        ssize_t written = ::writev(fd, iov, cnt);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("stdio: writev failed: ", strerror(errno));
+            return;
+        }
+
+        size_t remaining = static_cast<size_t>(written);
+        while (remaining > 0 && idx < chunks.size()) {
+            size_t avail = chunks[idx].size() - skip;
+            if (remaining >= avail) {
+                remaining -= avail;
+                ++idx;
+                skip = 0;
+            } else {
+                skip += remaining;
+                remaining = 0;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+void server::run_stdio_epoll(const std::string& session_id) {
+    const int stdin_fd = 0;
+    const int stdout_fd = 1;
+
+    int old_flags = ::fcntl(stdin_fd, F_GETFL, 0);
+    if (old_flags < 0 || ::fcntl(stdin_fd, F_SETFL, old_flags | O_NONBLOCK) < 0) {
+        LOG_WARNING("stdio: cannot make stdin non-blocking, using portable engine");
+        run_stdio_portable(session_id);
+        return;
+    }
+
+    int wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (wake_fd < 0 || epoll_fd < 0) {
+        if (wake_fd >= 0) ::close(wake_fd);
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        ::fcntl(stdin_fd, F_SETFL, old_flags);
+        LOG_WARNING("stdio: epoll setup failed, using portable engine");
+        run_stdio_portable(session_id);
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = stdin_fd;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stdin_fd, &ev);
+    ev.data.fd = wake_fd;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+    // Responses produced by worker threads queue here; the event loop swaps
+    // the batch out and writes it in one writev. Workers signal wake_fd so
+    // the loop does not sit in epoll_wait while output is pending. These
+    // locals outlive every worker task: the loop only exits once the
+    // outstanding count has dropped to zero and the queue has drained.
+    std::mutex out_mutex;
+    std::vector<std::string> out_queue;
+    std::atomic<size_t> outstanding{0};
+
+    auto enqueue_output = [&](std::string&& text) {
+        {
+            std::lock_guard<std::mutex> lock(out_mutex);
+            out_queue.push_back(std::move(text));
+        }
+        uint64_t one = 1;
+        ssize_t rc = ::write(wake_fd, &one, sizeof(one));
+        (void)rc;
+    };
+
+    std::string in_buffer;
+    size_t in_offset = 0;
+    bool eof = false;
+    char read_buf[65536];
+    std::vector<std::string> batch;
+
+    for (;;) {
+        if (eof && outstanding.load(std::memory_order_acquire) == 0) {
+            std::lock_guard<std::mutex> lock(out_mutex);
+            if (out_queue.empty()) {
+                break;
+            }
+        }
+
+        epoll_event events[4];
+        int n = ::epoll_wait(epoll_fd, events, 4, 100);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("stdio: epoll_wait failed: ", strerror(errno));
+            // Stop reading, but in-flight workers still reference this
+            // frame's locals (outstanding, the output queue, wake_fd) —
+            // drain them and flush their output before returning
+            ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, stdin_fd, nullptr);
+            while (outstanding.load(std::memory_order_acquire) > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(out_mutex);
+                batch.swap(out_queue);
+            }
+            if (!batch.empty()) {
+                write_all_iovec(stdout_fd, batch);
+            }
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.fd == wake_fd) {
+                uint64_t drained;
+                while (::read(wake_fd, &drained, sizeof(drained)) > 0) {
                 }
-                req.method = req_json.value("method", "");
-                if (req_json.contains("params")) {
-                    req.params = req_json["params"];
+                continue;
+            }
+
+            // stdin is readable: drain it, then frame and dispatch complete lines
+            for (;;) {
+                ssize_t bytes = ::read(stdin_fd, read_buf, sizeof(read_buf));
+                if (bytes > 0) {
+                    in_buffer.append(read_buf, static_cast<size_t>(bytes));
+                    continue;
                 }
-                
-                json res = process_request(req, session_id);
-                if (!res.is_null() && !req.id.is_null()) {
-                    std::cout << res.dump() << "\n" << std::flush;
+                if (bytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    eof = true;
+                    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, stdin_fd, nullptr);
+                }
+                if (bytes < 0 && errno == EINTR) continue;
+                break;
+            }
+
+            while (in_offset < in_buffer.size()) {
+                // The framing mode can flip once, after the initialize
+                // exchange accepts binary framing; every frame extracted
+                // after that is length-prefixed
+                const bool binary = stdio_binary_.load(std::memory_order_acquire);
+                std::string frame;
+
+                if (!binary) {
+                    const char* base = in_buffer.data() + in_offset;
+                    const char* newline = static_cast<const char*>(
+                        memchr(base, '\n', in_buffer.size() - in_offset));
+                    if (!newline) {
+                        break;
+                    }
+                    size_t line_length = static_cast<size_t>(newline - base);
+                    if (line_length > 0) {
+                        frame.assign(base, line_length);
+                    }
+                    in_offset = static_cast<size_t>(newline - in_buffer.data()) + 1;
                 } else {
-                    std::cerr << "Response is null or ID is null. Method: " << req.method << std::endl;
-                    if (!res.is_null()) {
-                        std::cout << res.dump() << "\n" << std::flush;
+                    if (in_buffer.size() - in_offset < sizeof(uint32_t)) {
+                        break;
                     }
+                    uint32_t length = frame_get_le32(in_buffer.data() + in_offset);
+                    if (length > max_stdio_frame_size) {
+                        LOG_ERROR("stdio: oversized binary frame (", length, " bytes), closing");
+                        eof = true;
+                        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, stdin_fd, nullptr);
+                        break;
+                    }
+                    if (in_buffer.size() - in_offset < sizeof(uint32_t) + length) {
+                        break;
+                    }
+                    frame.assign(in_buffer.data() + in_offset + sizeof(uint32_t), length);
+                    in_offset += sizeof(uint32_t) + length;
                 }
-            } else {
-                json err_res = {
-                    {"jsonrpc", "2.0"},
-                    {"error", {
-                        {"code", static_cast<int>(error_code::invalid_request)},
-                        {"message", "Invalid JSON-RPC format"}
-                    }}
-                };
-                if (req_json.contains("id")) {
-                    err_res["id"] = req_json["id"];
-                } else {
-                    err_res["id"] = nullptr;
+
+                if (!frame.empty()) {
+                    outstanding.fetch_add(1, std::memory_order_acq_rel);
+                    thread_pool_.enqueue([this, frame = std::move(frame), binary, &session_id,
+                                          &enqueue_output, &outstanding]() {
+                        std::string out = binary
+                            ? handle_stdio_binary_frame(frame, session_id)
+                            : handle_stdio_message(frame, session_id);
+                        if (!out.empty()) {
+                            enqueue_output(std::move(out));
+                        }
+                        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                    });
                 }
-                std::cout << err_res.dump() << "\n" << std::flush;
             }
-        } catch (const std::exception& e) {
-            json err_res = {
-                {"jsonrpc", "2.0"},
-                {"error", {
-                    {"code", static_cast<int>(error_code::parse_error)},
-                    {"message", std::string("Parse error: ") + e.what()}
-                }},
-                {"id", nullptr}
-            };
-            std::cout << err_res.dump() << "\n" << std::flush;
+
+            // Reclaim the consumed prefix lazily, same as the stdio client
+            if (in_offset >= in_buffer.size()) {
+                in_buffer.clear();
+                in_offset = 0;
+            } else if (in_offset >= 65536 && in_offset >= in_buffer.size() / 2) {
+                in_buffer.erase(0, in_offset);
+                in_offset = 0;
+            }
+        }
+
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock(out_mutex);
+            batch.swap(out_queue);
+        }
+        if (!batch.empty()) {
+            write_all_iovec(stdout_fd, batch);
         }
     }
-    running_ = false;
+
+    ::fcntl(stdin_fd, F_SETFL, old_flags);
+    ::close(wake_fd);
+    ::close(epoll_fd);
 }
 
+#endif // __linux__
+
 bool server::start(bool blocking) {
     if (running_) {
         return true;  // Already running
@@ -133,6 +587,19 @@ bool server::start(bool blocking) {
         res.status = 204; // No Content
     });
 
+    // Optional Prometheus metrics endpoint
+    if (!metrics_endpoint_.empty()) {
+        http_server_->Get(metrics_endpoint_.c_str(), [this](const httplib::Request&, httplib::Response& res) {
+            std::map<std::string, double> gauges = {
+                {"mcp_thread_pool_active_threads", static_cast<double>(thread_pool_.get_active_threads())},
+                {"mcp_thread_pool_queue_depth", static_cast<double>(thread_pool_.get_queue_depth())},
+                {"mcp_sessions", static_cast<double>(sessions_.session_count())}
+            };
+            res.set_content(metrics_registry::instance().to_prometheus(gauges),
+                            "text/plain; version=0.0.4");
+        });
+    }
+
     // Setup JSON-RPC endpoint (SSE transport)
     http_server_->Post(msg_endpoint_.c_str(), [this](const httplib::Request& req, httplib::Response& res) {
         this->handle_jsonrpc(req, res);
@@ -186,8 +653,67 @@ bool server::start(bool blocking) {
                 }
             }
         });
+
+        // One shared timer drives heartbeats for every legacy SSE session;
+        // the dispatcher queues hold the events until each connection's
+        // content provider drains them
+        heartbeat_thread_run_ = true;
+        heartbeat_thread_ = std::make_unique<std::thread>([this]() {
+            while (true) {
+                std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+                auto should_exit = heartbeat_cond_.wait_for(lock, std::chrono::seconds(5), [this] {
+                    return !heartbeat_thread_run_;
+                });
+                if (should_exit) {
+                    return;
+                }
+                lock.unlock();
+
+                try {
+                    send_sse_heartbeats();
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Exception in heartbeat thread: ", e.what());
+                } catch (...) {
+                    LOG_ERROR("Unknown exception in heartbeat thread");
+                }
+            }
+        });
+
+        // Flush thread for coalesced notifications; it sleeps until the
+        // first notification of a batch arrives, then wakes once per window
+        if (notification_coalesce_ms_ > 0) {
+            coalesce_thread_run_ = true;
+            coalesce_thread_ = std::make_unique<std::thread>([this]() {
+                const auto window = std::chrono::milliseconds(notification_coalesce_ms_);
+                while (true) {
+                    bool has_batches;
+                    {
+                        std::unique_lock<std::mutex> lock(coalesce_mutex_);
+                        coalesce_cond_.wait(lock, [this] {
+                            return !coalesce_thread_run_ || !notification_batches_.empty();
+                        });
+                        if (!coalesce_thread_run_) {
+                            return;
+                        }
+                        has_batches = !notification_batches_.empty();
+                    }
+
+                    if (has_batches) {
+                        std::this_thread::sleep_for(window);
+                    }
+
+                    try {
+                        flush_notification_batches(false);
+                    } catch (const std::exception& e) {
+                        LOG_ERROR("Exception in notification flush thread: ", e.what());
+                    } catch (...) {
+                        LOG_ERROR("Unknown exception in notification flush thread");
+                    }
+                }
+            });
+        }
     }
-    
+
     // Start server
     if (blocking) {
         running_ = true;
@@ -221,6 +747,10 @@ void server::stop() {
     LOG_INFO("Stopping MCP server on ", host_, ":", port_);
     running_ = false;
 
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    shutdown_shm_channels();
+#endif
+
     // Close maintenance thread
     if (maintenance_thread_ && maintenance_thread_->joinable()) {
         {
@@ -236,104 +766,51 @@ void server::stop() {
             maintenance_thread_->detach();
         }
     }
-    
-    // Copy all dispatchers and threads to avoid holding the lock for too long
-    std::vector<std::shared_ptr<event_dispatcher>> dispatchers_to_close;
-    std::vector<std::unique_ptr<std::thread>> threads_to_join;
-    
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        // Copy all dispatchers
-        dispatchers_to_close.reserve(session_dispatchers_.size());
-        for (const auto& [_, dispatcher] : session_dispatchers_) {
-            dispatchers_to_close.push_back(dispatcher);
+
+    // Close heartbeat thread
+    if (heartbeat_thread_ && heartbeat_thread_->joinable()) {
+        {
+            std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+            heartbeat_thread_run_ = false;
         }
-        
-        // Copy all threads
-        threads_to_join.reserve(sse_threads_.size());
-        for (auto& [_, thread] : sse_threads_) {
-            if (thread && thread->joinable()) {
-                threads_to_join.push_back(std::move(thread));
-            }
+
+        heartbeat_cond_.notify_one();
+
+        try {
+            heartbeat_thread_->join();
+        } catch (...) {
+            heartbeat_thread_->detach();
         }
-        
-        // Clear the maps
-        session_dispatchers_.clear();
-        sse_threads_.clear();
-        session_initialized_.clear();
-    }
-    
-    // Close all sessions
-    for (const auto& [session_id, _] : session_dispatchers_) {
-        close_session(session_id);
     }
-    
-    // Give threads some time to handle close events
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
-    
-    // Wait for threads to finish outside the lock (with timeout limit)
-    const auto timeout_point = std::chrono::steady_clock::now() + std::chrono::seconds(2);
-    
-    for (auto& thread : threads_to_join) {
-        if (!thread || !thread->joinable()) {
-            continue;
-        }
-        
-        if (std::chrono::steady_clock::now() >= timeout_point) {
-            // If timeout reached, detach remaining threads
-            LOG_WARNING("Thread join timeout reached, detaching remaining threads");
-            thread->detach();
-            continue;
+
+    // Close notification flush thread, then push out whatever was batched
+    if (coalesce_thread_ && coalesce_thread_->joinable()) {
+        {
+            std::unique_lock<std::mutex> lock(coalesce_mutex_);
+            coalesce_thread_run_ = false;
         }
-        
-        // Try using timeout join
-        bool joined = false;
+
+        coalesce_cond_.notify_one();
+
         try {
-            // Create future and promise for timeout join
-            std::promise<void> thread_done;
-            auto future = thread_done.get_future();
-            
-            // Try join in another thread
-            std::thread join_helper([&thread, &thread_done]() {
-                try {
-                    thread->join();
-                    thread_done.set_value();
-                } catch (...) {
-                    try {
-                        thread_done.set_exception(std::current_exception());
-                    } catch (...) {}
-                }
-            });
-            
-            // Wait for join to complete or timeout
-            if (future.wait_for(std::chrono::milliseconds(100)) == std::future_status::ready) {
-                future.get(); // Get possible exception
-                joined = true;
-            }
-            
-            // Process join_helper thread
-            if (join_helper.joinable()) {
-                if (joined) {
-                    join_helper.join();
-                } else {
-                    join_helper.detach();
-                }
-            }
+            coalesce_thread_->join();
         } catch (...) {
-            joined = false;
+            coalesce_thread_->detach();
         }
-        
-        // If join fails, then detach
-        if (!joined) {
-            try {
-                thread->detach();
-            } catch (...) {
-                // Ignore exceptions
-            }
+
+        flush_notification_batches(true);
+    }
+
+    // Take all sessions out of the registry, then close the dispatchers
+    // without holding any shard lock. The connection threads belong to
+    // httplib; closing a dispatcher wakes its content provider, which then
+    // returns false and ends the connection.
+    for (auto& removed : sessions_.clear()) {
+        if (removed.dispatcher && !removed.dispatcher->is_closed()) {
+            removed.dispatcher->close();
         }
     }
-    
+
     if (server_thread_ && server_thread_->joinable()) {
         http_server_->stop();
         try {
@@ -411,10 +888,74 @@ static bool match_uri_template(const std::string& tmpl,
     return ti == tmpl.size() && ui == uri.size();
 }
 
+const server::resource_template_entry* server::find_resource_template(
+    const std::string& uri, std::map<std::string, std::string>& params) const
+{
+    // Recently resolved binding for this exact URI?
+    {
+        std::lock_guard<std::mutex> lock(template_cache_mutex_);
+        auto it = template_match_cache_.find(uri);
+        if (it != template_match_cache_.end()) {
+            const auto& entry = resource_templates_[it->second];
+            if (match_uri_template(entry.uri_template, uri, params)) {
+                return &entry;
+            }
+            template_match_cache_.erase(it);
+        }
+    }
+
+    // Probe the static-prefix buckets, longest prefix first; only templates
+    // sharing the URI's leading literal are pattern-matched
+    for (size_t len : template_prefix_lengths_) {
+        if (len > uri.size()) {
+            continue;
+        }
+        auto bucket = template_prefix_index_.find(uri.substr(0, len));
+        if (bucket == template_prefix_index_.end()) {
+            continue;
+        }
+        for (size_t index : bucket->second) {
+            const auto& entry = resource_templates_[index];
+            if (match_uri_template(entry.uri_template, uri, params)) {
+                std::lock_guard<std::mutex> lock(template_cache_mutex_);
+                if (template_match_cache_.size() >= template_match_cache_limit) {
+                    template_match_cache_.clear();
+                }
+                template_match_cache_[uri] = index;
+                return &entry;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+// Read a static resource, honoring optional "offset"/"length" range
+// parameters for resources that can serve partial content
+static json read_resource_contents(const std::shared_ptr<resource>& res, const json& params) {
+    if (params.contains("offset") || params.contains("length")) {
+        auto mapped = std::dynamic_pointer_cast<mmap_file_resource>(res);
+        if (mapped) {
+            size_t offset = params.value("offset", static_cast<size_t>(0));
+            size_t length = params.contains("length")
+                ? params["length"].get<size_t>()
+                : std::numeric_limits<size_t>::max();
+            return mapped->read_range(offset, length);
+        }
+    }
+    return res->read();
+}
+
 void server::register_resource(const std::string& path, std::shared_ptr<resource> resource) {
     std::lock_guard<std::mutex> lock(mutex_);
     resources_[path] = resource;
 
+    // Invalidate the cached resources/list result
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        resources_list_cache_ = json();
+    }
+
     // Register methods for resource access
     if (method_handlers_.find("resources/read") == method_handlers_.end()) {
         method_handlers_["resources/read"] = [this](const json& params, const std::string& session_id) -> json {
@@ -428,19 +969,21 @@ void server::register_resource(const std::string& path, std::shared_ptr<resource
             auto it = resources_.find(uri);
             if (it != resources_.end()) {
                 json contents = json::array();
-                contents.push_back(it->second->read());
+                contents.push_back(read_resource_contents(it->second, params));
                 return json{{"contents", contents}};
             }
 
             // Try resource templates
-            for (const auto& tmpl : resource_templates_) {
-                std::map<std::string, std::string> uri_params;
-                if (match_uri_template(tmpl.uri_template, uri, uri_params)) {
-                    json result = tmpl.handler(uri, uri_params, session_id);
-                    json contents = json::array();
-                    contents.push_back(result);
-                    return json{{"contents", contents}};
+            std::map<std::string, std::string> uri_params;
+            if (const auto* tmpl = find_resource_template(uri, uri_params)) {
+                if (!tmpl->handler) {
+                    throw mcp_exception(error_code::internal_error,
+                                        "Resource template handler not bound: " + tmpl->uri_template);
                 }
+                json result = tmpl->handler(uri, uri_params, session_id);
+                json contents = json::array();
+                contents.push_back(result);
+                return json{{"contents", contents}};
             }
 
             throw mcp_exception(error_code::invalid_params, "Resource not found: " + uri);
@@ -449,20 +992,23 @@ void server::register_resource(const std::string& path, std::shared_ptr<resource
     
     if (method_handlers_.find("resources/list") == method_handlers_.end()) {
         method_handlers_["resources/list"] = [this](const json& params, const std::string& session_id) -> json {
-            json resources = json::array();
-        
-            for (const auto& [uri, res] : resources_) {
-                resources.push_back(res->get_metadata());
+            json result;
+            {
+                std::lock_guard<std::mutex> lock(list_cache_mutex_);
+                if (resources_list_cache_.is_null()) {
+                    json resources = json::array();
+                    for (const auto& [uri, res] : resources_) {
+                        resources.push_back(res->get_metadata());
+                    }
+                    resources_list_cache_ = json{{"resources", resources}};
+                }
+                result = resources_list_cache_;
             }
-            
-            json result = {
-                {"resources", resources}
-            };
-            
+
             if (params.contains("cursor")) {
                 result["nextCursor"] = "";
             }
-            
+
             return result;
         };
     }
@@ -509,6 +1055,22 @@ void server::register_resource_template(
     std::lock_guard<std::mutex> lock(mutex_);
     resource_templates_.push_back({uri_template, name, mime_type, description, std::move(handler)});
 
+    // Index the template under its static prefix (a fully static template
+    // indexes under its whole URI)
+    std::string prefix = uri_template.substr(0, uri_template.find('{'));
+    template_prefix_index_[prefix].push_back(resource_templates_.size() - 1);
+    if (std::find(template_prefix_lengths_.begin(), template_prefix_lengths_.end(),
+                  prefix.size()) == template_prefix_lengths_.end()) {
+        template_prefix_lengths_.insert(
+            std::upper_bound(template_prefix_lengths_.begin(), template_prefix_lengths_.end(),
+                             prefix.size(), std::greater<size_t>()),
+            prefix.size());
+    }
+    {
+        std::lock_guard<std::mutex> cache_lock(template_cache_mutex_);
+        template_match_cache_.clear();
+    }
+
     // Ensure resource read/list/template handlers are registered
     // (they may already exist if register_resource was called first)
     if (method_handlers_.find("resources/read") == method_handlers_.end()) {
@@ -522,17 +1084,19 @@ void server::register_resource_template(
             auto it = resources_.find(uri);
             if (it != resources_.end()) {
                 json contents = json::array();
-                contents.push_back(it->second->read());
+                contents.push_back(read_resource_contents(it->second, params));
                 return json{{"contents", contents}};
             }
-            for (const auto& tmpl : resource_templates_) {
-                std::map<std::string, std::string> uri_params;
-                if (match_uri_template(tmpl.uri_template, uri, uri_params)) {
-                    json result = tmpl.handler(uri, uri_params, session_id);
-                    json contents = json::array();
-                    contents.push_back(result);
-                    return json{{"contents", contents}};
+            std::map<std::string, std::string> uri_params;
+            if (const auto* tmpl = find_resource_template(uri, uri_params)) {
+                if (!tmpl->handler) {
+                    throw mcp_exception(error_code::internal_error,
+                                        "Resource template handler not bound: " + tmpl->uri_template);
                 }
+                json result = tmpl->handler(uri, uri_params, session_id);
+                json contents = json::array();
+                contents.push_back(result);
+                return json{{"contents", contents}};
             }
             throw mcp_exception(error_code::invalid_params, "Resource not found: " + uri);
         };
@@ -557,30 +1121,150 @@ void server::register_resource_template(
 void server::register_tool(const tool& tool, tool_handler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     tools_[tool.name] = std::make_pair(tool, handler);
-    
+
+    // Invalidate the cached tools/list result
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        tools_list_cache_ = json();
+    }
+
+    register_tool_method_handlers();
+}
+
+void server::register_tool_raw(const tool& tool, raw_tool_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    raw_tools_[tool.name] = std::make_pair(tool, std::move(handler));
+
+    // Invalidate the cached tools/list result
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        tools_list_cache_ = json();
+    }
+
+    register_tool_method_handlers();
+}
+
+void server::register_tool_streaming(const tool& tool, streaming_tool_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streaming_tools_[tool.name] = std::make_pair(tool, std::move(handler));
+
+    // Invalidate the cached tools/list result
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        tools_list_cache_ = json();
+    }
+
+    register_tool_method_handlers();
+}
+
+void server::register_tool_method_handlers() {
     // Register methods for tool listing and calling
     if (method_handlers_.find("tools/list") == method_handlers_.end()) {
         method_handlers_["tools/list"] = [this](const json& params, const std::string& session_id) -> json {
-            json tools_json = json::array();
-            for (const auto& [name, tool_pair] : tools_) {
-                tools_json.push_back(tool_pair.first.to_json());
+            std::lock_guard<std::mutex> lock(list_cache_mutex_);
+            if (tools_list_cache_.is_null()) {
+                json tools_json = json::array();
+                for (const auto& [name, tool_pair] : tools_) {
+                    tools_json.push_back(tool_pair.first.to_json());
+                }
+                for (const auto& [name, tool_pair] : raw_tools_) {
+                    tools_json.push_back(tool_pair.first.to_json());
+                }
+                for (const auto& [name, tool_pair] : streaming_tools_) {
+                    tools_json.push_back(tool_pair.first.to_json());
+                }
+                tools_list_cache_ = json{{"tools", tools_json}};
             }
-            return json{{"tools", tools_json}};
+            return tools_list_cache_;
         };
     }
-    
+
     if (method_handlers_.find("tools/call") == method_handlers_.end()) {
         method_handlers_["tools/call"] = [this](const json& params, const std::string& session_id) -> json {
             if (!params.contains("name")) {
                 throw mcp_exception(error_code::invalid_params, "Missing 'name' parameter");
             }
-            
+
             std::string tool_name = params["name"];
             auto it = tools_.find(tool_name);
             if (it == tools_.end()) {
-                throw mcp_exception(error_code::invalid_params, "Tool not found: " + tool_name);
+                // Streaming-registered tools get a writer wired to the
+                // session's event stream and the caller's progressToken
+                auto stream_it = streaming_tools_.find(tool_name);
+                if (stream_it != streaming_tools_.end()) {
+                    if (!stream_it->second.second) {
+                        throw mcp_exception(error_code::internal_error,
+                                            "Tool handler not bound: " + tool_name);
+                    }
+
+                    json tool_args = params.contains("arguments") ? params["arguments"] : json::object();
+
+                    json progress_token;
+                    if (params.contains("_meta") && params["_meta"].contains("progressToken")) {
+                        progress_token = params["_meta"]["progressToken"];
+                    }
+
+                    tool_stream_writer writer(sessions_.find_dispatcher(session_id),
+                                              std::move(progress_token));
+
+                    json tool_result = {
+                        {"isError", false}
+                    };
+
+                    try {
+                        tool_result["content"] = stream_it->second.second(tool_args, session_id, writer);
+                    } catch (const std::exception& e) {
+                        tool_result["isError"] = true;
+                        tool_result["content"] = json::array({
+                            {
+                                {"type", "text"},
+                                {"text", e.what()}
+                            }
+                        });
+                    }
+
+                    return tool_result;
+                }
+
+                // Raw-registered tools reached through the DOM path (legacy
+                // transport, batches, stdio) get the serialized arguments
+                auto raw_it = raw_tools_.find(tool_name);
+                if (raw_it == raw_tools_.end()) {
+                    throw mcp_exception(error_code::invalid_params, "Tool not found: " + tool_name);
+                }
+                if (!raw_it->second.second) {
+                    throw mcp_exception(error_code::internal_error,
+                                        "Tool handler not bound: " + tool_name);
+                }
+
+                json tool_args = params.contains("arguments") ? params["arguments"] : json::object();
+                std::string raw_args = tool_args.is_string() ? tool_args.get<std::string>()
+                                                             : tool_args.dump();
+
+                json tool_result = {
+                    {"isError", false}
+                };
+
+                try {
+                    tool_result["content"] = raw_it->second.second(raw_args, session_id);
+                } catch (const std::exception& e) {
+                    tool_result["isError"] = true;
+                    tool_result["content"] = json::array({
+                        {
+                            {"type", "text"},
+                            {"text", e.what()}
+                        }
+                    });
+                }
+
+                return tool_result;
             }
-            
+
+            if (!it->second.second) {
+                throw mcp_exception(error_code::internal_error,
+                                    "Tool handler not bound: " + tool_name);
+            }
+
             json tool_args = params.contains("arguments") ? params["arguments"] : json::array();
 
             if (tool_args.is_string()) {
@@ -615,15 +1299,25 @@ void server::register_tool(const tool& tool, tool_handler handler) {
 void server::register_prompt(const prompt& prompt, prompt_handler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     prompts_[prompt.name] = std::make_pair(prompt, handler);
-    
+
+    // Invalidate the cached prompts/list result
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        prompts_list_cache_ = json();
+    }
+
     // Register methods for prompt listing and calling
     if (method_handlers_.find("prompts/list") == method_handlers_.end()) {
         method_handlers_["prompts/list"] = [this](const json& params, const std::string& session_id) -> json {
-            json prompts_json = json::array();
-            for (const auto& [name, prompt_pair] : prompts_) {
-                prompts_json.push_back(prompt_pair.first.to_json());
+            std::lock_guard<std::mutex> lock(list_cache_mutex_);
+            if (prompts_list_cache_.is_null()) {
+                json prompts_json = json::array();
+                for (const auto& [name, prompt_pair] : prompts_) {
+                    prompts_json.push_back(prompt_pair.first.to_json());
+                }
+                prompts_list_cache_ = json{{"prompts", prompts_json}};
             }
-            return json{{"prompts", prompts_json}};
+            return prompts_list_cache_;
         };
     }
     
@@ -639,6 +1333,11 @@ void server::register_prompt(const prompt& prompt, prompt_handler handler) {
                 throw mcp_exception(error_code::invalid_params, "Prompt not found: " + prompt_name);
             }
             
+            if (!it->second.second) {
+                throw mcp_exception(error_code::internal_error,
+                                    "Prompt handler not bound: " + prompt_name);
+            }
+
             json prompt_args = params.contains("arguments") ? params["arguments"] : json::object();
             
             json handler_result = it->second.second(prompt_args, session_id);
@@ -660,6 +1359,222 @@ void server::register_prompt(const prompt& prompt, prompt_handler handler) {
     }
 }
 
+bool server::save_registry_snapshot(const std::string& path) const {
+    json payload;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        json tools_json = json::array();
+        for (const auto& [name, tool_pair] : tools_) {
+            tools_json.push_back({{"kind", "plain"}, {"def", tool_pair.first.to_json()}});
+        }
+        for (const auto& [name, tool_pair] : raw_tools_) {
+            tools_json.push_back({{"kind", "raw"}, {"def", tool_pair.first.to_json()}});
+        }
+        for (const auto& [name, tool_pair] : streaming_tools_) {
+            tools_json.push_back({{"kind", "streaming"}, {"def", tool_pair.first.to_json()}});
+        }
+
+        json prompts_json = json::array();
+        for (const auto& [name, prompt_pair] : prompts_) {
+            prompts_json.push_back(prompt_pair.first.to_json());
+        }
+
+        json templates_json = json::array();
+        for (const auto& tmpl : resource_templates_) {
+            templates_json.push_back({
+                {"uriTemplate", tmpl.uri_template},
+                {"name", tmpl.name},
+                {"mimeType", tmpl.mime_type},
+                {"description", tmpl.description}
+            });
+        }
+
+        payload = {
+            {"tools", tools_json},
+            {"prompts", prompts_json},
+            {"resourceTemplates", templates_json}
+        };
+    }
+
+    std::vector<uint8_t> packed = json::to_msgpack(payload);
+
+    registry_snapshot_header header;
+    header.magic = registry_snapshot_magic;
+    header.version = registry_snapshot_version;
+    header.payload_size = packed.size();
+    header.payload_hash = fnv1a_hash(packed.data(), packed.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        LOG_ERROR("Failed to open registry snapshot for writing: ", path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+    if (!out) {
+        LOG_ERROR("Failed to write registry snapshot: ", path);
+        return false;
+    }
+    return true;
+}
+
+bool server::load_registry_snapshot(const std::string& path) {
+    json payload;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open registry snapshot: ", path);
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(registry_snapshot_header)) {
+        LOG_ERROR("Registry snapshot too small: ", path);
+        ::close(fd);
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_ERROR("Failed to map registry snapshot: ", path);
+        return false;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(mapped);
+    const size_t file_size = static_cast<size_t>(st.st_size);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Failed to open registry snapshot: ", path);
+        return false;
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto* bytes = reinterpret_cast<const uint8_t*>(contents.data());
+    const size_t file_size = contents.size();
+    if (file_size < sizeof(registry_snapshot_header)) {
+        LOG_ERROR("Registry snapshot too small: ", path);
+        return false;
+    }
+#endif
+
+    bool valid = false;
+    registry_snapshot_header header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != registry_snapshot_magic) {
+        LOG_ERROR("Registry snapshot has wrong magic: ", path);
+    } else if (header.version != registry_snapshot_version) {
+        LOG_ERROR("Registry snapshot has unsupported version ", header.version, ": ", path);
+    } else if (header.payload_size != file_size - sizeof(header)) {
+        LOG_ERROR("Registry snapshot is truncated: ", path);
+    } else if (header.payload_hash != fnv1a_hash(bytes + sizeof(header), header.payload_size)) {
+        LOG_ERROR("Registry snapshot failed hash validation: ", path);
+    } else {
+        try {
+            payload = json::from_msgpack(bytes + sizeof(header),
+                                         bytes + sizeof(header) + header.payload_size);
+            valid = true;
+        } catch (const json::exception& e) {
+            LOG_ERROR("Failed to decode registry snapshot: ", e.what());
+        }
+    }
+
+#ifndef _WIN32
+    ::munmap(mapped, st.st_size);
+#endif
+    if (!valid) {
+        return false;
+    }
+
+    // Rebuild the registries with prebuilt schemas and no handlers bound;
+    // the register_* calls also install the method handlers
+    json tools_list = json::array();
+    for (const auto& entry : payload.value("tools", json::array())) {
+        const json& def = entry["def"];
+        tool restored;
+        restored.name = def.value("name", "");
+        restored.description = def.value("description", "");
+        restored.parameters_schema = def.value("inputSchema", json::object());
+        if (def.contains("annotations")) {
+            restored.annotations = def["annotations"];
+        }
+
+        const std::string kind = entry.value("kind", "plain");
+        if (kind == "raw") {
+            register_tool_raw(restored, nullptr);
+        } else if (kind == "streaming") {
+            register_tool_streaming(restored, nullptr);
+        } else {
+            register_tool(restored, nullptr);
+        }
+        tools_list.push_back(def);
+    }
+
+    json prompts_list = json::array();
+    for (const auto& def : payload.value("prompts", json::array())) {
+        prompt restored;
+        restored.name = def.value("name", "");
+        restored.description = def.value("description", "");
+        for (const auto& arg : def.value("arguments", json::array())) {
+            restored.arguments.push_back({arg.value("name", ""),
+                                          arg.value("description", ""),
+                                          arg.value("required", false)});
+        }
+        register_prompt(restored, nullptr);
+        prompts_list.push_back(def);
+    }
+
+    for (const auto& def : payload.value("resourceTemplates", json::array())) {
+        register_resource_template(def.value("uriTemplate", ""),
+                                   def.value("name", ""),
+                                   def.value("mimeType", ""),
+                                   def.value("description", ""),
+                                   nullptr);
+    }
+
+    // Prime the list caches straight from the snapshot, so the first
+    // tools/list and prompts/list don't re-serialize the registries
+    {
+        std::lock_guard<std::mutex> cache_lock(list_cache_mutex_);
+        tools_list_cache_ = json{{"tools", std::move(tools_list)}};
+        prompts_list_cache_ = json{{"prompts", std::move(prompts_list)}};
+    }
+
+    return true;
+}
+
+bool server::bind_tool_handler(const std::string& name, tool_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tools_.find(name);
+    if (it == tools_.end()) {
+        return false;
+    }
+    it->second.second = std::move(handler);
+    return true;
+}
+
+bool server::bind_prompt_handler(const std::string& name, prompt_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = prompts_.find(name);
+    if (it == prompts_.end()) {
+        return false;
+    }
+    it->second.second = std::move(handler);
+    return true;
+}
+
+bool server::bind_resource_template_handler(const std::string& uri_template,
+                                            resource_template_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& tmpl : resource_templates_) {
+        if (tmpl.uri_template == uri_template) {
+            tmpl.handler = std::move(handler);
+            return true;
+        }
+    }
+    return false;
+}
+
 void server::register_session_cleanup(const std::string& key, session_cleanup_handler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     session_cleanup_handler_[key] = handler;
@@ -676,95 +1591,52 @@ std::vector<tool> server::get_tools() const {
     return tools;
 }
 
-void server::set_auth_handler(auth_handler handler) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auth_handler_ = handler;
+std::shared_ptr<session_context> server::get_session_context(const std::string& session_id) const {
+    return sessions_.find_context(session_id);
 }
 
-void server::handle_sse(const httplib::Request& req, httplib::Response& res) {
-    // Enforce session limit
-    if (max_sessions_ > 0) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (session_dispatchers_.size() >= max_sessions_) {
-            LOG_WARNING("Max sessions reached (", max_sessions_, "), rejecting SSE connection");
-            res.status = 503;
-            res.set_content("{\"error\":\"Too many sessions\"}", "application/json");
-            return;
-        }
-    }
+void server::set_auth_handler(auth_handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auth_handler_ = handler;
+}
 
+void server::handle_sse(const httplib::Request& req, httplib::Response& res) {
     std::string session_id = generate_session_id();
     std::string session_uri = msg_endpoint_ + "?session_id=" + session_id;
-    
+
     // Setup SSE response headers
     res.set_header("Content-Type", "text/event-stream");
     res.set_header("Cache-Control", "no-cache");
     res.set_header("Connection", "keep-alive");
     res.set_header("Access-Control-Allow-Origin", "*");
-    
+
     // Create session-specific event dispatcher
     auto session_dispatcher = std::make_shared<event_dispatcher>();
-    
+
     // Initialize activity time
     session_dispatcher->update_activity();
-    
-    // Add session dispatcher to mapping table
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        session_dispatchers_[session_id] = session_dispatcher;
+
+    // Add session to the registry, enforcing the session limit
+    if (!sessions_.try_add_session(session_id, session_dispatcher, max_sessions_)) {
+        LOG_WARNING("Max sessions reached (", max_sessions_, "), rejecting SSE connection");
+        res.status = 503;
+        res.set_content("{\"error\":\"Too many sessions\"}", "application/json");
+        return;
     }
-    
-    // Create session thread
-    auto thread = std::make_unique<std::thread>([this, res, session_id, session_uri, session_dispatcher]() {
-        try {
-            // Send initial session URI
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            std::stringstream ss;
-            ss << "event: endpoint\r\ndata: " << session_uri << "\r\n\r\n";
-            session_dispatcher->send_event(ss.str());
-            
-            // Update activity time (after sending message)
-            session_dispatcher->update_activity();
-            
-            // Send periodic heartbeats to detect connection status
-            int heartbeat_count = 0;
-            while (running_ && !session_dispatcher->is_closed()) {
-               std::this_thread::sleep_for(std::chrono::seconds(5) + std::chrono::milliseconds(rand() % 500)); // NOTE: DO NOT set it the same as the timeout of wait_event
-                
-                if (session_dispatcher->is_closed() || !running_) {
-                    break;
-                }
-                
-                std::stringstream heartbeat;
-                heartbeat << "event: heartbeat\r\ndata: " << heartbeat_count++ << "\r\n\r\n";
-                
-                try {
-                    bool sent = session_dispatcher->send_event(heartbeat.str());
-                    if (!sent) {
-                        LOG_WARNING("Failed to send heartbeat, client may have closed connection: ", session_id);
-                        break;
-                    }
-                    
-                    // Update activity time (heartbeat successful)
-                    session_dispatcher->update_activity();
-                } catch (const std::exception& e) {
-                    LOG_ERROR("Failed to send heartbeat: ", e.what());
-                    break;
-                }
-            }
-        } catch (const std::exception& e) {
-            LOG_ERROR("SSE session thread exception: ", session_id, ", ", e.what());
-        }
-        
-        close_session(session_id);
-    });
-    
-    // Store thread
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        sse_threads_[session_id] = std::move(thread);
+    if (session_timeout_ > 0) {
+        sessions_.arm_expiry(session_id,
+                             std::chrono::steady_clock::now() + std::chrono::seconds(session_timeout_));
     }
-    
+
+    // Queue the initial session URI; the dispatcher holds it until the
+    // chunked content provider below attaches and drains the queue. Further
+    // heartbeats come from the shared heartbeat timer instead of a dedicated
+    // thread per connection.
+    std::stringstream ss;
+    ss << "event: endpoint\r\ndata: " << session_uri << "\r\n\r\n";
+    session_dispatcher->send_event(ss.str());
+    session_dispatcher->enable_heartbeat();
+
     // Setup chunked content provider
     res.set_chunked_content_provider("text/event-stream", [this, session_id, session_dispatcher](size_t /* offset */, httplib::DataSink& sink) {
         try {
@@ -819,15 +1691,7 @@ void server::handle_jsonrpc(const httplib::Request& req, httplib::Response& res)
 
     // Update session activity time
     if (!session_id.empty()) {
-        std::shared_ptr<event_dispatcher> dispatcher;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto disp_it = session_dispatchers_.find(session_id);
-            if (disp_it != session_dispatchers_.end()) {
-                dispatcher = disp_it->second;
-            }
-        }
-        
+        auto dispatcher = sessions_.find_dispatcher(session_id);
         if (dispatcher) {
             dispatcher->update_activity();
         }
@@ -845,23 +1709,18 @@ void server::handle_jsonrpc(const httplib::Request& req, httplib::Response& res)
     }
     
     // Check if session exists
-    std::shared_ptr<event_dispatcher> dispatcher;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto disp_it = session_dispatchers_.find(session_id);
-        if (disp_it == session_dispatchers_.end()) {
-            // Handle ping request
-            if (req_json["method"] == "ping") {
-                res.status = 202;
-                res.set_content("Accepted", "text/plain");
-                return;
-            }
-            LOG_ERROR("Session not found: ", session_id);
-            res.status = 404;
-            res.set_content("{\"error\":\"Session not found\"}", "application/json");
+    std::shared_ptr<event_dispatcher> dispatcher = sessions_.find_dispatcher(session_id);
+    if (!dispatcher) {
+        // Handle ping request
+        if (req_json["method"] == "ping") {
+            res.status = 202;
+            res.set_content("Accepted", "text/plain");
             return;
         }
-        dispatcher = disp_it->second;
+        LOG_ERROR("Session not found: ", session_id);
+        res.status = 404;
+        res.set_content("{\"error\":\"Session not found\"}", "application/json");
+        return;
     }
     
     // Create request object
@@ -899,12 +1758,15 @@ void server::handle_jsonrpc(const httplib::Request& req, httplib::Response& res)
     thread_pool_.enqueue([this, mcp_req, session_id, dispatcher]() {
         // Process the request
         json response_json = process_request(mcp_req, session_id);
-        
-        // Send response via SSE
-        std::stringstream ss;
-        ss << "event: message\r\ndata: " << response_json.dump() << "\r\n\r\n";
-        bool result = dispatcher->send_event(ss.str());
-        
+
+        // Send response via SSE; the serialized body is moved into the event
+        // queue as its own chunk, so large results are never re-copied
+        std::vector<std::string> chunks;
+        chunks.emplace_back("event: message\r\ndata: ");
+        chunks.push_back(response_json.dump());
+        chunks.emplace_back("\r\n\r\n");
+        bool result = dispatcher->send_event_chunks(std::move(chunks));
+
         if (!result) {
             LOG_ERROR("Failed to send response via SSE: session_id=", session_id);
         }
@@ -942,6 +1804,17 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
     res.set_header("Access-Control-Expose-Headers", "Mcp-Session-Id, MCP-Protocol-Version");
     res.set_header("MCP-Protocol-Version", MCP_VERSION);
 
+    // Get or create session
+    std::string session_id = req.get_header_value("Mcp-Session-Id");
+
+    // Streaming parse fast path: a tools/call for a raw-registered tool is
+    // served from an envelope scan, without DOM-parsing the (possibly huge)
+    // arguments; anything the scanner does not handle falls through to the
+    // regular parse below
+    if (try_handle_raw_tool_call(req.body, session_id, res)) {
+        return;
+    }
+
     // Parse JSON body
     json body;
     try {
@@ -955,9 +1828,6 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
         return;
     }
 
-    // Get or create session
-    std::string session_id = req.get_header_value("Mcp-Session-Id");
-
     // Check if this is an initialize request (no session needed)
     bool is_initialize = false;
     if (body.is_object() && body.contains("method") && body["method"] == "initialize") {
@@ -966,8 +1836,7 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
 
     // Reject re-initialization on an existing session
     if (is_initialize && !session_id.empty()) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (session_dispatchers_.find(session_id) != session_dispatchers_.end()) {
+        if (sessions_.contains(session_id)) {
             res.status = 400;
             res.set_content("{\"error\":\"Session already initialized. Delete and re-create.\"}",
                             "application/json");
@@ -982,8 +1851,7 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
             res.set_content("{\"error\":\"Missing Mcp-Session-Id header\"}", "application/json");
             return;
         }
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (session_dispatchers_.find(session_id) == session_dispatchers_.end()) {
+        if (!sessions_.contains(session_id)) {
             // Session expired or invalid — client must re-initialize
             res.status = 404;
             res.set_content("{\"error\":\"Session not found\"}", "application/json");
@@ -1026,24 +1894,19 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
     // Has requests — process and decide response format
     // For initialize: create session, return inline JSON with Mcp-Session-Id header
     if (is_initialize) {
-        // Enforce session limit
-        if (max_sessions_ > 0) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (session_dispatchers_.size() >= max_sessions_) {
-                res.status = 503;
-                res.set_content("{\"error\":\"Too many sessions\"}", "application/json");
-                return;
-            }
-        }
-
         session_id = generate_session_id();
 
         // Create session dispatcher for server-push via GET
         auto session_dispatcher = std::make_shared<event_dispatcher>();
         session_dispatcher->update_activity();
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            session_dispatchers_[session_id] = session_dispatcher;
+        if (!sessions_.try_add_session(session_id, session_dispatcher, max_sessions_)) {
+            res.status = 503;
+            res.set_content("{\"error\":\"Too many sessions\"}", "application/json");
+            return;
+        }
+        if (session_timeout_ > 0) {
+            sessions_.arm_expiry(session_id,
+                                 std::chrono::steady_clock::now() + std::chrono::seconds(session_timeout_));
         }
 
         auto mcp_req = parse_jsonrpc_message(items[0]);
@@ -1059,8 +1922,11 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
     std::string accept = req.get_header_value("Accept");
     bool client_accepts_sse = accept.find("text/event-stream") != std::string::npos;
 
-    // Process all items, collect responses for requests
+    // Process all items, collect responses for requests.
+    // Batches are fanned out across the thread pool so the members run in
+    // parallel; single requests stay inline to avoid the enqueue overhead.
     json responses = json::array();
+    std::vector<std::future<json>> batch_futures;
     for (const auto& item : items) {
         auto mcp_req = parse_jsonrpc_message(item);
 
@@ -1070,9 +1936,28 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
             continue;
         }
 
-        // Process request synchronously (inline response)
-        json result = process_request(mcp_req, session_id);
-        responses.push_back(result);
+        if (items.size() == 1) {
+            // Process request synchronously (inline response)
+            json result = process_request(mcp_req, session_id);
+            responses.push_back(result);
+        } else {
+            batch_futures.push_back(thread_pool_.enqueue(
+                [this, mcp_req, session_id]() -> json {
+                    return process_request(mcp_req, session_id);
+                }));
+        }
+    }
+
+    // Join the fanned-out batch members, preserving request order
+    for (auto& future : batch_futures) {
+        try {
+            responses.push_back(future.get());
+        } catch (const std::exception& e) {
+            LOG_ERROR("Exception processing batch member: ", e.what());
+            responses.push_back(response::create_error(
+                nullptr, error_code::internal_error,
+                "Internal error: " + std::string(e.what())).to_json());
+        }
     }
 
     if (responses.empty()) {
@@ -1105,6 +1990,98 @@ void server::handle_mcp_post(const httplib::Request& req, httplib::Response& res
     }
 }
 
+bool server::try_handle_raw_tool_call(const std::string& body, const std::string& session_id, httplib::Response& res) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (raw_tools_.empty()) {
+            return false;
+        }
+    }
+
+#ifdef MCP_JSON_ARENA
+    // Every JSON value built on this fast path (request id, result wrapper,
+    // serialized response) dies before we return, so the whole call can run
+    // out of the thread's arena
+    arena_scope json_arena;
+#endif
+
+    // Scan the JSON-RPC envelope without building a DOM; batches and
+    // malformed bodies fail the scan and take the regular path
+    json_scan::jsonrpc_envelope env;
+    if (!json_scan::scan_jsonrpc_envelope(body, env)) {
+        return false;
+    }
+    if (env.jsonrpc != "2.0" || env.method != "tools/call" ||
+        env.id_raw.empty() || env.params_raw.empty()) {
+        return false;
+    }
+
+    // The fast path only serves established, initialized sessions; anything
+    // else falls through so the regular path produces the proper error
+    if (session_id.empty() || !sessions_.contains(session_id) || !is_session_initialized(session_id)) {
+        return false;
+    }
+
+    // Pull the tool name and the raw argument bytes out of params
+    std::string tool_name;
+    std::string_view raw_arguments;
+    bool params_ok = json_scan::scan_object(env.params_raw,
+        [&](std::string_view key, std::string_view value) {
+            if (key == "name") {
+                tool_name = std::string(json_scan::unquote(value));
+            } else if (key == "arguments") {
+                raw_arguments = value;
+            }
+        });
+    if (!params_ok || tool_name.empty()) {
+        return false;
+    }
+
+    raw_tool_handler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = raw_tools_.find(tool_name);
+        if (it == raw_tools_.end()) {
+            return false;
+        }
+        handler = it->second.second;
+    }
+    if (!handler) {
+        // Snapshot-restored tool whose handler was never bound; fall through
+        // so the regular path produces the "handler not bound" error
+        return false;
+    }
+
+    json id;
+    try {
+        id = json::parse(env.id_raw);
+    } catch (const json::exception&) {
+        return false;
+    }
+
+    LOG_INFO("Processing tools/call via streaming parse fast path: ", tool_name);
+
+    json tool_result = {
+        {"isError", false}
+    };
+
+    try {
+        tool_result["content"] = handler(raw_arguments, session_id);
+    } catch (const std::exception& e) {
+        tool_result["isError"] = true;
+        tool_result["content"] = json::array({
+            {
+                {"type", "text"},
+                {"text", e.what()}
+            }
+        });
+    }
+
+    res.set_header("Content-Type", "application/json");
+    res.set_content(response::create_success(std::move(id), std::move(tool_result)).to_json().dump(), "application/json");
+    return true;
+}
+
 void server::handle_mcp_get(const httplib::Request& req, httplib::Response& res) {
     // CORS headers
     res.set_header("Access-Control-Allow-Origin", "*");
@@ -1121,16 +2098,11 @@ void server::handle_mcp_get(const httplib::Request& req, httplib::Response& res)
     }
 
     // Validate session
-    std::shared_ptr<event_dispatcher> dispatcher;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = session_dispatchers_.find(session_id);
-        if (it == session_dispatchers_.end()) {
-            res.status = 404;
-            res.set_content("{\"error\":\"Session not found\"}", "application/json");
-            return;
-        }
-        dispatcher = it->second;
+    std::shared_ptr<event_dispatcher> dispatcher = sessions_.find_dispatcher(session_id);
+    if (!dispatcher) {
+        res.status = 404;
+        res.set_content("{\"error\":\"Session not found\"}", "application/json");
+        return;
     }
 
     if (!is_session_initialized(session_id)) {
@@ -1196,12 +2168,9 @@ void server::handle_mcp_delete(const httplib::Request& req, httplib::Response& r
         return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (session_dispatchers_.find(session_id) == session_dispatchers_.end()) {
-            res.status = 404;
-            return;
-        }
+    if (!sessions_.contains(session_id)) {
+        res.status = 404;
+        return;
     }
 
     close_session(session_id);
@@ -1217,6 +2186,12 @@ json server::process_request(const request& req, const std::string& session_id)
         return json::object();
     }
     
+#ifndef MCP_DISABLE_METRICS
+    // Resolve the method's metrics entry once per request; the samples
+    // recorded below are then only relaxed atomic increments
+    method_metrics& request_metrics = metrics_registry::instance().method(req.method);
+#endif
+
     // Process method call
     try {
         LOG_INFO("Processing method call: ", req.method);
@@ -1249,12 +2224,20 @@ json server::process_request(const request& req, const std::string& session_id)
         
         if (handler) {
             // Call handler
-            LOG_INFO("Calling method handler: ", req.method);            
+            LOG_INFO("Calling method handler: ", req.method);
+#ifndef MCP_DISABLE_METRICS
+            const auto handler_start = std::chrono::steady_clock::now();
+#endif
             json result = handler(req.params, session_id);
-            
+#ifndef MCP_DISABLE_METRICS
+            request_metrics.record_call(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - handler_start).count());
+#endif
+
             // Create success response
             LOG_INFO("Method call successful: ", req.method);
-            return response::create_success(req.id, result).to_json();
+            return response::create_success(req.id, std::move(result)).to_json();
         }
         
         // Method not found
@@ -1267,6 +2250,9 @@ json server::process_request(const request& req, const std::string& session_id)
     } catch (const mcp_exception& e) {
         // MCP exception
         LOG_ERROR("MCP exception: ", e.what(), ", code: ", static_cast<int>(e.code()));
+#ifndef MCP_DISABLE_METRICS
+        request_metrics.record_error();
+#endif
         return response::create_error(
             req.id,
             e.code(),
@@ -1275,6 +2261,9 @@ json server::process_request(const request& req, const std::string& session_id)
     } catch (const std::exception& e) {
         // Other exceptions
         LOG_ERROR("Exception while processing request: ", e.what());
+#ifndef MCP_DISABLE_METRICS
+        request_metrics.record_error();
+#endif
         return response::create_error(
             req.id,
             error_code::internal_error,
@@ -1283,6 +2272,9 @@ json server::process_request(const request& req, const std::string& session_id)
     } catch (...) {
         // Unknown exception
         LOG_ERROR("Unknown exception while processing request");
+#ifndef MCP_DISABLE_METRICS
+        request_metrics.record_error();
+#endif
         return response::create_error(
             req.id,
             error_code::internal_error,
@@ -1348,8 +2340,8 @@ json server::handle_initialize(const request& req, const std::string& session_id
     }
 
     LOG_INFO("Initialization successful, waiting for notifications/initialized notification");
-    
-    return response::create_success(req.id, result).to_json();
+
+    return response::create_success(req.id, std::move(result)).to_json();
 }
 
 void server::send_jsonrpc(const std::string& session_id, const json& message) {
@@ -1359,29 +2351,35 @@ void server::send_jsonrpc(const std::string& session_id, const json& message) {
         return;
     }
 
+    // Notifications may be coalesced; responses and requests go out directly
+    if (notification_coalesce_ms_ > 0 && coalesce_thread_ &&
+        message.contains("method") && !message.contains("id")) {
+        queue_notification(session_id, message);
+        return;
+    }
+
     // Get session dispatcher
-    std::shared_ptr<event_dispatcher> dispatcher;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = session_dispatchers_.find(session_id);
-        if (it == session_dispatchers_.end()) {
-            LOG_ERROR("Session not found: ", session_id);
-            return;
-        }
-        dispatcher = it->second;
+    std::shared_ptr<event_dispatcher> dispatcher = sessions_.find_dispatcher(session_id);
+    if (!dispatcher) {
+        LOG_ERROR("Session not found: ", session_id);
+        return;
     }
-    
+
+
     // Confirm dispatcher is still valid
     if (!dispatcher || dispatcher->is_closed()) {
         LOG_WARNING("Cannot send to closed session: ", session_id);
         return;
     }
     
-    // Send message
-    std::stringstream ss;
-    ss << "event: message\r\ndata: " << message.dump() << "\r\n\r\n";
-    bool result = dispatcher->send_event(ss.str());
-    
+    // Send message as framing + payload chunks; the serialized body is moved
+    // into the event queue rather than concatenated into one buffer
+    std::vector<std::string> chunks;
+    chunks.emplace_back("event: message\r\ndata: ");
+    chunks.push_back(message.dump());
+    chunks.emplace_back("\r\n\r\n");
+    bool result = dispatcher->send_event_chunks(std::move(chunks));
+
     if (!result) {
         LOG_ERROR("Failed to send message to session: ", session_id);
     }
@@ -1391,34 +2389,131 @@ void server::send_request(const std::string& session_id, const request& req) {
     send_jsonrpc(session_id, req.to_json());
 }
 
-void server::broadcast_notification(const request& notification) {
-    std::vector<std::string> sessions;
+void server::queue_notification(const std::string& session_id, const json& message) {
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& [sid, initialized] : session_initialized_) {
-            if (initialized) {
-                sessions.push_back(sid);
+        std::lock_guard<std::mutex> lock(coalesce_mutex_);
+        auto& batch = notification_batches_[session_id];
+        if (batch.messages.empty()) {
+            batch.deadline = std::chrono::steady_clock::now() +
+                             std::chrono::milliseconds(notification_coalesce_ms_);
+        }
+
+        // A burst of updated-notifications for one URI collapses to the
+        // latest one, kept at its original position in the batch
+        if (message.value("method", "") == "notifications/resources/updated" &&
+            message.contains("params") && message["params"].contains("uri") &&
+            message["params"]["uri"].is_string()) {
+            const std::string uri = message["params"]["uri"].get<std::string>();
+            auto it = batch.updated_uris.find(uri);
+            if (it != batch.updated_uris.end()) {
+                batch.messages[it->second] = message;
+                return;
             }
+            batch.updated_uris[uri] = batch.messages.size();
         }
+
+        batch.messages.push_back(message);
     }
-    for (const auto& sid : sessions) {
-        try {
-            send_jsonrpc(sid, notification.to_json());
-        } catch (...) {
-            // Best-effort delivery; don't fail if one session is broken
+    coalesce_cond_.notify_one();
+}
+
+void server::flush_notification_batches(bool force) {
+    const auto now = std::chrono::steady_clock::now();
+
+    // Splice due batches out under the lock, then serialize and send
+    // without it so queue_notification never blocks on I/O
+    std::vector<std::pair<std::string, notification_batch>> due;
+    {
+        std::lock_guard<std::mutex> lock(coalesce_mutex_);
+        for (auto it = notification_batches_.begin(); it != notification_batches_.end();) {
+            if (force || it->second.deadline <= now) {
+                due.emplace_back(it->first, std::move(it->second));
+                it = notification_batches_.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
-}
 
-std::vector<std::string> server::get_active_sessions() const {
-    std::vector<std::string> sessions;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& [sid, initialized] : session_initialized_) {
-        if (initialized) {
-            sessions.push_back(sid);
+    for (auto& [session_id, batch] : due) {
+        auto dispatcher = sessions_.find_dispatcher(session_id);
+        if (!dispatcher || dispatcher->is_closed()) {
+            continue; // session went away while the batch was open
+        }
+
+        // One buffer holding every event of the batch, so the whole burst
+        // leaves in a single queue entry and a single sink write
+        std::string payload;
+        for (const auto& message : batch.messages) {
+            payload += "event: message\r\ndata: ";
+            payload += message.dump();
+            payload += "\r\n\r\n";
+        }
+
+        if (!dispatcher->send_event(std::move(payload))) {
+            LOG_ERROR("Failed to send notification batch to session: ", session_id);
         }
     }
-    return sessions;
+}
+
+std::future<void> server::broadcast_notification(const request& notification) {
+    struct broadcast_state {
+        std::atomic<size_t> remaining{0};
+        std::promise<void> done;
+    };
+    auto state = std::make_shared<broadcast_state>();
+    auto future = state->done.get_future();
+
+    auto session_ids = sessions_.initialized_sessions();
+    if (session_ids.empty()) {
+        state->done.set_value();
+        return future;
+    }
+
+    // Serialize once; every session queues a reference to the same buffer
+    auto payload = std::make_shared<const std::string>(notification.to_json().dump());
+
+    constexpr size_t batch_size = 64;
+    const size_t batches = (session_ids.size() + batch_size - 1) / batch_size;
+    state->remaining.store(batches, std::memory_order_relaxed);
+
+    for (size_t b = 0; b < batches; ++b) {
+        const size_t begin = b * batch_size;
+        const size_t end = std::min(begin + batch_size, session_ids.size());
+        std::vector<std::string> batch(session_ids.begin() + begin, session_ids.begin() + end);
+
+        thread_pool_.enqueue([this, state, payload, batch = std::move(batch)]() {
+            for (const auto& sid : batch) {
+                try {
+                    auto dispatcher = sessions_.find_dispatcher(sid);
+                    if (dispatcher && !dispatcher->is_closed()) {
+                        dispatcher->send_event_shared("event: message\r\ndata: ", payload, "\r\n\r\n");
+                    }
+                } catch (...) {
+                    // Best-effort delivery; don't fail if one session is broken
+                }
+            }
+            if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                state->done.set_value();
+            }
+        });
+    }
+
+    return future;
+}
+
+json server::get_stats() const {
+    json stats = metrics_registry::instance().to_json();
+    stats["thread_pool"] = {
+        {"active_threads", thread_pool_.get_active_threads()},
+        {"queue_depth", thread_pool_.get_queue_depth()}
+    };
+    stats["sessions"] = sessions_.session_count();
+    return stats;
+}
+
+std::vector<std::string> server::get_active_sessions() const {
+    return sessions_.initialized_sessions();
 }
 
 bool server::is_session_initialized(const std::string& session_id) const {
@@ -1426,15 +2521,8 @@ bool server::is_session_initialized(const std::string& session_id) const {
     if (session_id.empty()) {
         return false;
     }
-    
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = session_initialized_.find(session_id);
-        return (it != session_initialized_.end() && it->second);
-    } catch (const std::exception& e) {
-        LOG_ERROR("Exception checking if session is initialized: ", e.what());
-        return false;
-    }
+
+    return sessions_.is_initialized(session_id);
 }
 
 void server::set_session_initialized(const std::string& session_id, bool initialized) {
@@ -1444,22 +2532,12 @@ void server::set_session_initialized(const std::string& session_id, bool initial
         return;
     }
 
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        // Check if session still exists (either SSE or HTTP mode)
-        auto it = session_dispatchers_.find(session_id);
-        bool has_dispatcher = (it != session_dispatchers_.end());
-
-        // For HTTP mode, we also track initialization in session_initialized_ map
-        // So we allow setting initialized state even without a dispatcher for HTTP sessions
-        if (!has_dispatcher) {
-            LOG_DEBUG("Setting initialization state for HTTP session: ", session_id);
-        }
-
-        session_initialized_[session_id] = initialized;
-    } catch (const std::exception& e) {
-        LOG_ERROR("Exception setting session initialization state: ", e.what());
+    // For HTTP mode, we also track initialization even without a dispatcher
+    if (!sessions_.contains(session_id)) {
+        LOG_DEBUG("Setting initialization state for HTTP session: ", session_id);
     }
+
+    sessions_.set_initialized(session_id, initialized);
 }
 
 std::string server::generate_session_id() const {
@@ -1501,29 +2579,49 @@ std::string server::generate_session_id() const {
 void server::check_inactive_sessions() {
     if (!running_ || session_timeout_ == 0) return;
 
-    const auto now = std::chrono::steady_clock::now();
-    const auto timeout = std::chrono::seconds(session_timeout_);
-    
-    std::vector<std::string> sessions_to_close;
-    
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& [session_id, dispatcher] : session_dispatchers_) {
-            if (now - dispatcher->last_activity() > timeout) {
-                // Exceeded idle time limit
-                sessions_to_close.push_back(session_id);
+    // Only sessions whose expiry bucket is due are inspected; sessions that
+    // saw activity since their bucket was armed are re-armed by the registry
+    auto sessions_to_close = sessions_.collect_expired(
+        std::chrono::seconds(session_timeout_),
+        [this](const std::string& session_id) {
+            auto dispatcher = sessions_.find_dispatcher(session_id);
+            if (!dispatcher) {
+                return std::chrono::steady_clock::time_point::min();
             }
-        }
-    }
-    
+            return dispatcher->last_activity();
+        });
+
     // Close inactive sessions
     for (const auto& session_id : sessions_to_close) {
         LOG_INFO("Closing inactive session: ", session_id);
-        
+
         close_session(session_id);
     }
 }
 
+void server::send_sse_heartbeats() {
+    // Snapshot the opted-in dispatchers under the shard locks, then queue the
+    // heartbeat events without holding any registry lock
+    std::vector<std::pair<std::string, std::shared_ptr<event_dispatcher>>> targets;
+    sessions_.for_each_dispatcher(
+        [&targets](const std::string& session_id, const std::shared_ptr<event_dispatcher>& dispatcher) {
+            if (dispatcher && dispatcher->heartbeat_enabled() && !dispatcher->is_closed()) {
+                targets.emplace_back(session_id, dispatcher);
+            }
+        });
+
+    for (const auto& [session_id, dispatcher] : targets) {
+        std::stringstream heartbeat;
+        heartbeat << "event: heartbeat\r\ndata: " << dispatcher->next_heartbeat() << "\r\n\r\n";
+        if (dispatcher->send_event(heartbeat.str())) {
+            dispatcher->update_activity();
+        } else {
+            LOG_WARNING("Failed to send heartbeat, client may have closed connection: ", session_id);
+            close_session(session_id);
+        }
+    }
+}
+
 bool server::set_mount_point(const std::string& mount_point, const std::string& dir, httplib::Headers headers) {
     return http_server_->set_mount_point(mount_point, dir, headers);
 }
@@ -1535,39 +2633,12 @@ void server::close_session(const std::string& session_id) {
             handler(key);
         }
 
-        // Copy resources to be processed
-        std::shared_ptr<event_dispatcher> dispatcher_to_close;
-        std::unique_ptr<std::thread> thread_to_release;
-        
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            
-            // Get dispatcher pointer
-            auto dispatcher_it = session_dispatchers_.find(session_id);
-            if (dispatcher_it != session_dispatchers_.end()) {
-                dispatcher_to_close = dispatcher_it->second;
-                session_dispatchers_.erase(dispatcher_it);
-            }
-            
-            // Get thread pointer
-            auto thread_it = sse_threads_.find(session_id);
-            if (thread_it != sse_threads_.end()) {
-                thread_to_release = std::move(thread_it->second);
-                sse_threads_.erase(thread_it);
-            }
-            
-            // Clean up initialization status
-            session_initialized_.erase(session_id);
-        }
-        
+        // Take the session out of the registry; close and release outside any lock
+        auto removed = sessions_.remove_session(session_id);
+
         // Close dispatcher outside the lock
-        if (dispatcher_to_close && !dispatcher_to_close->is_closed()) {
-            dispatcher_to_close->close();
-        }
-        
-        // Release thread resources
-        if (thread_to_release) {
-            thread_to_release.release();
+        if (removed.dispatcher && !removed.dispatcher->is_closed()) {
+            removed.dispatcher->close();
         }
     } catch (const std::exception& e) {
         LOG_WARNING("Exception while cleaning up session resources: ", session_id, ", ", e.what());
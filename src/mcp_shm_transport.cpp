@@ -0,0 +1,352 @@
+/**
+ * @file mcp_shm_transport.cpp
+ * @brief Implementation of the shared-memory message channel
+ */
+
+#include "mcp_shm_transport.h"
+
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+
+#include "mcp_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <random>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace mcp {
+
+namespace detail {
+
+// One ring direction: free-running head/tail positions plus a process-shared
+// condition variable used both by the reader (waiting for data) and the
+// writer (waiting for space)
+struct ring_control {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    std::atomic<uint64_t> head;  // consumer position
+    std::atomic<uint64_t> tail;  // producer position
+};
+
+struct shm_segment {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ring_capacity;
+    std::atomic<uint32_t> closed;
+    ring_control c2s;  // client -> server, written by the segment owner
+    ring_control s2c;  // server -> client
+    // Followed by the two data rings: c2s bytes, then s2c bytes
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory rings require lock-free 64-bit atomics");
+
+} // namespace detail
+
+namespace {
+
+constexpr uint32_t kShmMagic = 0x4d435053;  // "MCPS"
+constexpr uint32_t kShmVersion = 1;
+constexpr size_t kFrameHeaderSize = sizeof(uint32_t);
+constexpr int kSpinIterations = 4000;
+
+size_t segment_size(size_t ring_capacity) {
+    return sizeof(detail::shm_segment) + 2 * ring_capacity;
+}
+
+char* ring_data(detail::shm_segment* segment, bool c2s) {
+    char* base = reinterpret_cast<char*>(segment + 1);
+    return c2s ? base : base + segment->ring_capacity;
+}
+
+bool init_ring_control(detail::ring_control& ring) {
+    pthread_mutexattr_t mutex_attr;
+    pthread_condattr_t cond_attr;
+    if (pthread_mutexattr_init(&mutex_attr) != 0) return false;
+    if (pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED) != 0) {
+        pthread_mutexattr_destroy(&mutex_attr);
+        return false;
+    }
+    bool ok = pthread_mutex_init(&ring.mutex, &mutex_attr) == 0;
+    pthread_mutexattr_destroy(&mutex_attr);
+    if (!ok) return false;
+
+    if (pthread_condattr_init(&cond_attr) != 0) return false;
+    ok = pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED) == 0 &&
+         pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC) == 0 &&
+         pthread_cond_init(&ring.cond, &cond_attr) == 0;
+    pthread_condattr_destroy(&cond_attr);
+    if (!ok) return false;
+
+    ring.head.store(0, std::memory_order_relaxed);
+    ring.tail.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void wake_ring(detail::ring_control& ring) {
+    pthread_mutex_lock(&ring.mutex);
+    pthread_cond_broadcast(&ring.cond);
+    pthread_mutex_unlock(&ring.mutex);
+}
+
+// Copy into/out of the ring with wraparound
+void ring_write_bytes(char* data, size_t capacity, uint64_t pos, const char* src, size_t n) {
+    size_t index = static_cast<size_t>(pos % capacity);
+    size_t first = std::min(n, capacity - index);
+    std::memcpy(data + index, src, first);
+    if (first < n) {
+        std::memcpy(data, src + first, n - first);
+    }
+}
+
+void ring_read_bytes(const char* data, size_t capacity, uint64_t pos, char* dst, size_t n) {
+    size_t index = static_cast<size_t>(pos % capacity);
+    size_t first = std::min(n, capacity - index);
+    std::memcpy(dst, data + index, first);
+    if (first < n) {
+        std::memcpy(dst + first, data, n - first);
+    }
+}
+
+struct timespec deadline_after(std::chrono::milliseconds timeout) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeout.count() / 1000;
+    ts.tv_nsec += (timeout.count() % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+std::string generate_segment_name() {
+    static std::atomic<uint64_t> counter{0};
+    std::random_device rd;
+    return "/mcp-shm-" + std::to_string(::getpid()) + "-" +
+           std::to_string(counter.fetch_add(1)) + "-" + std::to_string(rd() & 0xffffff);
+}
+
+} // anonymous namespace
+
+std::unique_ptr<shm_channel> shm_channel::create(size_t ring_capacity) {
+    if (ring_capacity < 4096) {
+        ring_capacity = 4096;
+    }
+
+    std::string name = generate_segment_name();
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        LOG_WARNING("shm_open failed for ", name, ": ", std::strerror(errno));
+        return nullptr;
+    }
+
+    size_t total = segment_size(ring_capacity);
+    if (::ftruncate(fd, static_cast<off_t>(total)) == -1) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    void* mapped = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    auto* segment = new (mapped) detail::shm_segment();
+    segment->version = kShmVersion;
+    segment->ring_capacity = ring_capacity;
+    segment->closed.store(0, std::memory_order_relaxed);
+    if (!init_ring_control(segment->c2s) || !init_ring_control(segment->s2c)) {
+        ::munmap(mapped, total);
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    // Magic is published last so an opener never sees a half-initialized segment
+    segment->magic = kShmMagic;
+
+    return std::unique_ptr<shm_channel>(new shm_channel(std::move(name), true, segment, total));
+}
+
+std::unique_ptr<shm_channel> shm_channel::open(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd == -1) {
+        LOG_WARNING("shm_open failed for ", name, ": ", std::strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(detail::shm_segment)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t total = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto* segment = static_cast<detail::shm_segment*>(mapped);
+    if (segment->magic != kShmMagic || segment->version != kShmVersion ||
+        segment_size(segment->ring_capacity) != total) {
+        ::munmap(mapped, total);
+        return nullptr;
+    }
+
+    return std::unique_ptr<shm_channel>(new shm_channel(name, false, segment, total));
+}
+
+shm_channel::shm_channel(std::string name, bool owner, detail::shm_segment* segment,
+                         size_t mapped_size)
+    : name_(std::move(name)), owner_(owner), segment_(segment), mapped_size_(mapped_size) {}
+
+shm_channel::~shm_channel() {
+    close();
+    ::munmap(segment_, mapped_size_);
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+bool shm_channel::write_frame(const std::string& payload) {
+    // The owner (client) produces into c2s; the opener (server) into s2c
+    detail::ring_control& ring = owner_ ? segment_->c2s : segment_->s2c;
+    char* data = ring_data(segment_, owner_);
+    const size_t capacity = segment_->ring_capacity;
+
+    const size_t frame_size = kFrameHeaderSize + payload.size();
+    if (frame_size > capacity || payload.size() > UINT32_MAX) {
+        return false;  // can never fit; caller should use the pipe
+    }
+
+    // Wait for space: spin briefly, then sleep on the ring's doorbell
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    for (;;) {
+        if (segment_->closed.load(std::memory_order_acquire)) {
+            return false;
+        }
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        if (capacity - (tail - head) >= frame_size) {
+            break;
+        }
+
+        bool spun_free = false;
+        for (int i = 0; i < kSpinIterations; ++i) {
+            head = ring.head.load(std::memory_order_acquire);
+            if (capacity - (tail - head) >= frame_size) {
+                spun_free = true;
+                break;
+            }
+        }
+        if (spun_free) {
+            break;
+        }
+
+        struct timespec ts = deadline_after(std::chrono::milliseconds(100));
+        pthread_mutex_lock(&ring.mutex);
+        head = ring.head.load(std::memory_order_acquire);
+        if (capacity - (tail - head) < frame_size &&
+            !segment_->closed.load(std::memory_order_acquire)) {
+            pthread_cond_timedwait(&ring.cond, &ring.mutex, &ts);
+        }
+        pthread_mutex_unlock(&ring.mutex);
+    }
+
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    char header[kFrameHeaderSize];
+    std::memcpy(header, &length, kFrameHeaderSize);
+    ring_write_bytes(data, capacity, tail, header, kFrameHeaderSize);
+    ring_write_bytes(data, capacity, tail + kFrameHeaderSize, payload.data(), payload.size());
+    ring.tail.store(tail + frame_size, std::memory_order_release);
+
+    wake_ring(ring);
+    return true;
+}
+
+bool shm_channel::read_frame(std::string& payload, std::chrono::milliseconds timeout) {
+    detail::ring_control& ring = owner_ ? segment_->s2c : segment_->c2s;
+    const char* data = ring_data(segment_, !owner_);
+    const size_t capacity = segment_->ring_capacity;
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+    // Wait for data: spin briefly for the sub-10us case, then sleep
+    if (ring.tail.load(std::memory_order_acquire) == head) {
+        bool have_data = false;
+        for (int i = 0; i < kSpinIterations; ++i) {
+            if (ring.tail.load(std::memory_order_acquire) != head) {
+                have_data = true;
+                break;
+            }
+        }
+        if (!have_data) {
+            if (segment_->closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            struct timespec ts = deadline_after(timeout);
+            pthread_mutex_lock(&ring.mutex);
+            while (ring.tail.load(std::memory_order_acquire) == head &&
+                   !segment_->closed.load(std::memory_order_acquire)) {
+                if (pthread_cond_timedwait(&ring.cond, &ring.mutex, &ts) == ETIMEDOUT) {
+                    break;
+                }
+            }
+            pthread_mutex_unlock(&ring.mutex);
+            if (ring.tail.load(std::memory_order_acquire) == head) {
+                return false;
+            }
+        }
+    }
+
+    uint32_t length = 0;
+    char header[kFrameHeaderSize];
+    ring_read_bytes(data, capacity, head, header, kFrameHeaderSize);
+    std::memcpy(&length, header, kFrameHeaderSize);
+
+    // write_frame never produces a frame larger than the ring, so a bigger
+    // length means the segment is corrupted (or the peer is hostile); stop
+    // trusting it entirely
+    if (kFrameHeaderSize + static_cast<size_t>(length) > capacity) {
+        close();
+        return false;
+    }
+
+    payload.resize(length);
+    ring_read_bytes(data, capacity, head + kFrameHeaderSize, payload.data(), length);
+    ring.head.store(head + kFrameHeaderSize + length, std::memory_order_release);
+
+    // Wake a writer that may be waiting for space
+    wake_ring(ring);
+    return true;
+}
+
+void shm_channel::close() {
+    uint32_t expected = 0;
+    if (!segment_->closed.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+        return;
+    }
+    wake_ring(segment_->c2s);
+    wake_ring(segment_->s2c);
+}
+
+bool shm_channel::is_closed() const {
+    return segment_->closed.load(std::memory_order_acquire) != 0;
+}
+
+} // namespace mcp
+
+#endif // MCP_SHM_TRANSPORT_AVAILABLE
@@ -23,24 +23,116 @@ sse_client::~sse_client() {
 
 
 void sse_client::init_client(const std::string& scheme_host_port, bool validate_certificates, const std::string& ca_cert_path) {
-    http_client_ = std::make_unique<httplib::Client>(scheme_host_port.c_str());
+    validate_certificates_ = validate_certificates;
+    ca_cert_path_ = ca_cert_path;
+
     sse_client_ = std::make_unique<httplib::Client>(scheme_host_port.c_str());
 
-    http_client_->set_connection_timeout(timeout_seconds_, 0);
-    http_client_->set_read_timeout(timeout_seconds_, 0);
-    http_client_->set_write_timeout(timeout_seconds_, 0);
-    
     sse_client_->set_connection_timeout(timeout_seconds_ * 2, 0);
     sse_client_->set_write_timeout(timeout_seconds_, 0);
 
     #ifdef MCP_SSL
-    http_client_->enable_server_certificate_verification(validate_certificates);
     sse_client_->enable_server_certificate_verification(validate_certificates);
     if (!ca_cert_path.empty()) {
-        http_client_->set_ca_cert_path(ca_cert_path.c_str());
         sse_client_->set_ca_cert_path(ca_cert_path.c_str());
     }
     #endif
+
+    // POST connections for the message endpoint are pooled and created on
+    // demand; see acquire_post_client()
+}
+
+std::unique_ptr<httplib::Client> sse_client::create_post_client() {
+    auto client = std::make_unique<httplib::Client>(scheme_host_port_.c_str());
+
+    int timeout;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout = timeout_seconds_;
+    }
+
+    client->set_connection_timeout(timeout, 0);
+    client->set_read_timeout(timeout, 0);
+    client->set_write_timeout(timeout, 0);
+    client->set_keep_alive(true);
+
+    #ifdef MCP_SSL
+    client->enable_server_certificate_verification(validate_certificates_);
+    if (!ca_cert_path_.empty()) {
+        client->set_ca_cert_path(ca_cert_path_.c_str());
+    }
+    #endif
+
+    return client;
+}
+
+std::unique_ptr<httplib::Client> sse_client::acquire_post_client() {
+    {
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+
+        if (!idle_post_clients_.empty()) {
+            auto client = std::move(idle_post_clients_.back());
+            idle_post_clients_.pop_back();
+            return client;
+        }
+
+        if (post_clients_created_ >= post_pool_capacity_) {
+            // Pool exhausted; wait for a connection to come back, or for
+            // the capacity to grow enough to create a new one
+            pool_cv_.wait(lock, [this] {
+                return !idle_post_clients_.empty() ||
+                       post_clients_created_ < post_pool_capacity_;
+            });
+            if (!idle_post_clients_.empty()) {
+                auto client = std::move(idle_post_clients_.back());
+                idle_post_clients_.pop_back();
+                return client;
+            }
+        }
+
+        ++post_clients_created_;
+    }
+
+    // Create outside the pool lock; the slot was already reserved above
+    return create_post_client();
+}
+
+void sse_client::release_post_client(std::unique_ptr<httplib::Client> client) {
+    if (!client) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+
+    if (post_clients_created_ > post_pool_capacity_) {
+        // Pool was shrunk while this connection was in flight; drop it
+        --post_clients_created_;
+        return;
+    }
+
+    idle_post_clients_.push_back(std::move(client));
+    pool_cv_.notify_one();
+}
+
+void sse_client::set_connection_pool_size(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        post_pool_capacity_ = size;
+
+        // Drop idle connections beyond the new capacity; in-flight ones are
+        // dropped as they are returned
+        while (!idle_post_clients_.empty() && post_clients_created_ > post_pool_capacity_) {
+            idle_post_clients_.pop_back();
+            --post_clients_created_;
+        }
+    }
+
+    // Blocked acquirers may now be allowed to create a connection
+    pool_cv_.notify_all();
 }
 
 bool sse_client::initialize(const std::string& client_name, const std::string& client_version) {
@@ -126,29 +218,33 @@ void sse_client::set_auth_token(const std::string& token) {
 }
 
 void sse_client::set_header(const std::string& key, const std::string& value) {
+    // Pooled POST connections receive the headers per request
     std::lock_guard<std::mutex> lock(mutex_);
     default_headers_[key] = value;
-    
-    if (http_client_) {
-        http_client_->set_default_headers({{key, value}});
-    }
+
     if (sse_client_) {
         sse_client_->set_default_headers({{key, value}});
     }
 }
 
 void sse_client::set_timeout(int timeout_seconds) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    timeout_seconds_ = timeout_seconds;
-    
-    if (http_client_) {
-        http_client_->set_connection_timeout(timeout_seconds_, 0);
-        http_client_->set_write_timeout(timeout_seconds_, 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout_seconds_ = timeout_seconds;
+
+        if (sse_client_) {
+            sse_client_->set_connection_timeout(timeout_seconds_ * 2, 0);
+            sse_client_->set_write_timeout(timeout_seconds_, 0);
+        }
     }
-    
-    if (sse_client_) {
-        sse_client_->set_connection_timeout(timeout_seconds_ * 2, 0);
-        sse_client_->set_write_timeout(timeout_seconds_, 0);
+
+    // Apply to idle pooled connections; in-flight ones pick the new value
+    // up when they are next created
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    for (auto& client : idle_post_clients_) {
+        client->set_connection_timeout(timeout_seconds, 0);
+        client->set_read_timeout(timeout_seconds, 0);
+        client->set_write_timeout(timeout_seconds, 0);
     }
 }
 
@@ -186,7 +282,11 @@ json sse_client::call_tool(const std::string& tool_name, const json& arguments)
 }
 
 std::vector<tool> sse_client::get_tools() {
-    json response_json = send_request("tools/list", {}).result;
+    json response_json;
+    if (!cache_lookup("tools/list", response_json)) {
+        response_json = send_request("tools/list", {}).result;
+        cache_store("tools/list", response_json);
+    }
     std::vector<tool> tools;
     
     json tools_json;
@@ -221,14 +321,27 @@ json sse_client::list_resources(const std::string& cursor) {
     json params = json::object();
     if (!cursor.empty()) {
         params["cursor"] = cursor;
+        // Paginated requests bypass the cache; only the first page is reused
+        return send_request("resources/list", params).result;
+    }
+    json result;
+    if (!cache_lookup("resources/list", result)) {
+        result = send_request("resources/list", params).result;
+        cache_store("resources/list", result);
     }
-    return send_request("resources/list", params).result;
+    return result;
 }
 
 json sse_client::read_resource(const std::string& resource_uri) {
-    return send_request("resources/read", {
-        {"uri", resource_uri}
-    }).result;
+    json result;
+    const std::string cache_key = "resources/read:" + resource_uri;
+    if (!cache_lookup(cache_key, result)) {
+        result = send_request("resources/read", {
+            {"uri", resource_uri}
+        }).result;
+        cache_store(cache_key, result);
+    }
+    return result;
 }
 
 json sse_client::subscribe_to_resource(const std::string& resource_uri) {
@@ -238,7 +351,12 @@ json sse_client::subscribe_to_resource(const std::string& resource_uri) {
 }
 
 json sse_client::list_resource_templates() {
-    return send_request("resources/templates/list").result;
+    json result;
+    if (!cache_lookup("resources/templates/list", result)) {
+        result = send_request("resources/templates/list").result;
+        cache_store("resources/templates/list", result);
+    }
+    return result;
 }
 
 void sse_client::open_sse_connection() {
@@ -330,6 +448,46 @@ void sse_client::open_sse_connection() {
     });
 }
 
+std::future<json> sse_client::register_pending(const std::string& id_key) {
+    std::promise<json> response_promise;
+    std::future<json> response_future = response_promise.get_future();
+
+    auto& shard = shard_for(id_key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.requests[id_key] = std::move(response_promise);
+    }
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    return response_future;
+}
+
+bool sse_client::complete_pending(const std::string& id_key, json value) {
+    std::promise<json> response_promise;
+    auto& shard = shard_for(id_key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.requests.find(id_key);
+        if (it == shard.requests.end()) {
+            return false;
+        }
+        response_promise = std::move(it->second);
+        shard.requests.erase(it);
+    }
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+
+    // Fulfill outside the shard lock so the woken caller never contends on it
+    response_promise.set_value(std::move(value));
+    return true;
+}
+
+void sse_client::erase_pending(const std::string& id_key) {
+    auto& shard = shard_for(id_key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.requests.erase(id_key) > 0) {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
 bool sse_client::parse_sse_data(const char* data, size_t length) {
     try {
         // Split into lines and process event fields
@@ -379,25 +537,26 @@ bool sse_client::parse_sse_data(const char* data, size_t length) {
                     // Use the same serialization method as when storing the request ID
                     std::string id_key = response["id"].dump();
 
-                    std::lock_guard<std::mutex> lock(response_mutex_);
-                    auto it = pending_requests_.find(id_key);
-                    if (it != pending_requests_.end()) {
-                        if (response.contains("result")) {
-                            it->second.set_value(response["result"]);
-                        } else if (response.contains("error")) {
-                            json error_result = {
-                                {"isError", true},
-                                {"error", response["error"]}
-                            };
-                            it->second.set_value(error_result);
-                        } else {
-                            it->second.set_value(json::object());
-                        }
-
-                        pending_requests_.erase(it);
+                    json value;
+                    if (response.contains("result")) {
+                        value = response["result"];
+                    } else if (response.contains("error")) {
+                        value = json{
+                            {"isError", true},
+                            {"error", response["error"]}
+                        };
                     } else {
+                        value = json::object();
+                    }
+
+                    if (!complete_pending(id_key, std::move(value))) {
                         LOG_WARNING("Received response for unknown request ID: ", id_key);
                     }
+                } else if (response.contains("jsonrpc") && response.contains("method")) {
+                    // Server-initiated notification
+                    LOG_INFO("Received notification: ", response["method"]);
+                    cache_apply_notification(response["method"].get<std::string>(),
+                                             response.value("params", json::object()));
                 } else {
                     LOG_WARNING("Received invalid JSON-RPC response: ", response.dump());
                 }
@@ -461,59 +620,75 @@ void sse_client::close_sse_connection() {
 }
 
 json sse_client::send_jsonrpc(const request& req) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (msg_endpoint_.empty()) {
-        throw mcp_exception(error_code::internal_error, "Message endpoint not set, SSE connection may not be established");
-    }
-    
-    json req_json = req.to_json();
-    std::string req_body = req_json.dump();
-    
+    // Snapshot the endpoint and headers under the lock, then run the POST
+    // outside it so concurrent senders do not serialize on each other
+    std::string endpoint;
+    int timeout_seconds;
     httplib::Headers headers;
     headers.emplace("Content-Type", "application/json");
     headers.emplace("Accept", "application/json, text/event-stream");
-    
-    for (const auto& [key, value] : default_headers_) {
-        headers.emplace(key, value);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (msg_endpoint_.empty()) {
+            throw mcp_exception(error_code::internal_error, "Message endpoint not set, SSE connection may not be established");
+        }
+
+        endpoint = msg_endpoint_;
+        timeout_seconds = timeout_seconds_;
+
+        for (const auto& [key, value] : default_headers_) {
+            headers.emplace(key, value);
+        }
     }
-    
+
+    json req_json = req.to_json();
+    std::string req_body = req_json.dump();
+
+    // Run the POST over a pooled keep-alive connection, returning it to the
+    // pool as soon as the POST completes (the response arrives via SSE)
+    auto do_post = [&]() -> httplib::Result {
+        auto client = acquire_post_client();
+        try {
+            auto result = client->Post(endpoint, headers, req_body, "application/json");
+            release_post_client(std::move(client));
+            return result;
+        } catch (...) {
+            // Hand the slot back even when the POST throws, or the pool
+            // would leak capacity until every acquire blocks forever
+            release_post_client(std::move(client));
+            throw;
+        }
+    };
+
     if (req.is_notification()) {
-        auto result = http_client_->Post(msg_endpoint_, headers, req_body, "application/json");
-        
+        auto result = do_post();
+
         if (!result) {
             auto err = result.error();
             std::string error_msg = httplib::to_string(err);
             LOG_ERROR("JSON-RPC request failed: ", error_msg);
             throw mcp_exception(error_code::internal_error, error_msg);
         }
-        
+
         return json::object();
     }
-    
-    std::promise<json> response_promise;
-    std::future<json> response_future = response_promise.get_future();
 
     // Use the JSON-serialized id as key to ensure type consistency
-    json req_id_json = req.to_json()["id"];
+    json req_id_json = req_json["id"];
     std::string req_id_key = req_id_json.dump();
 
-    {
-        std::lock_guard<std::mutex> response_lock(response_mutex_);
-        pending_requests_[req_id_key] = std::move(response_promise);
-    }
-    
-    auto result = http_client_->Post(msg_endpoint_, headers, req_body, "application/json");
-    
+    std::future<json> response_future = register_pending(req_id_key);
+
+    auto result = do_post();
+
     if (!result) {
         auto err = result.error();
         std::string error_msg = httplib::to_string(err);
         
-        {
-            std::lock_guard<std::mutex> response_lock(response_mutex_);
-            pending_requests_.erase(req_id_key);
-        }
-        
+        erase_pending(req_id_key);
+
         LOG_ERROR("JSON-RPC request failed: ", error_msg);
         throw mcp_exception(error_code::internal_error, error_msg);
     }
@@ -522,11 +697,8 @@ json sse_client::send_jsonrpc(const request& req) {
         try {
             json res_json = json::parse(result->body);
             
-            {
-                std::lock_guard<std::mutex> response_lock(response_mutex_);
-                pending_requests_.erase(req_id_key);
-            }
-            
+            erase_pending(req_id_key);
+
             if (res_json.contains("error")) {
                 int code = res_json["error"]["code"];
                 std::string message = res_json["error"]["message"];
@@ -540,17 +712,14 @@ json sse_client::send_jsonrpc(const request& req) {
                 return json::object();
             }
         } catch (const json::exception& e) {
-            {
-                std::lock_guard<std::mutex> response_lock(response_mutex_);
-                pending_requests_.erase(req_id_key);
-            }
-            
+            erase_pending(req_id_key);
+
             throw mcp_exception(error_code::parse_error, 
                             "Failed to parse JSON-RPC response: " + std::string(e.what()));
         }
     } else {
-        const auto timeout = std::chrono::seconds(timeout_seconds_);
-        
+        const auto timeout = std::chrono::seconds(timeout_seconds);
+
         auto status = response_future.wait_for(timeout);
         
         if (status == std::future_status::ready) {
@@ -568,11 +737,8 @@ json sse_client::send_jsonrpc(const request& req) {
             
             return response;
         } else {
-            {
-                std::lock_guard<std::mutex> response_lock(response_mutex_);
-                pending_requests_.erase(req_id_key);
-            }
-            
+            erase_pending(req_id_key);
+
             throw mcp_exception(error_code::internal_error, "Timeout waiting for SSE response");
         }
     }
@@ -28,6 +28,26 @@
 
 namespace mcp {
 
+namespace {
+
+// Length prefix for negotiated binary framing: 4 bytes, little-endian on
+// the wire regardless of host byte order
+void frame_put_le32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value & 0xff);
+    out[1] = static_cast<char>((value >> 8) & 0xff);
+    out[2] = static_cast<char>((value >> 16) & 0xff);
+    out[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+uint32_t frame_get_le32(const char* in) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(in[0])) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[1])) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[2])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(in[3])) << 24);
+}
+
+} // anonymous namespace
+
 stdio_client::stdio_client(const std::string& command, const json& env_vars, const json& capabilities)
     : command_(command), capabilities_(capabilities), env_vars_(env_vars) {
     
@@ -46,20 +66,67 @@ bool stdio_client::initialize(const std::string& client_name, const std::string&
         return false;
     }
     
+    json capabilities = capabilities_;
+    if (binary_requested_) {
+        capabilities["experimental"]["binary_framing"] = {{"encoding", "msgpack"}};
+    }
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    // Offer the shared-memory channel; the segment must exist before the
+    // server sees the initialize request
+    if (shm_requested_) {
+        shm_ = shm_channel::create(shm_ring_capacity_);
+        if (shm_) {
+            capabilities["experimental"]["shm"] = {{"name", shm_->name()}};
+        } else {
+            LOG_WARNING("Shared-memory channel creation failed, staying on pipe transport");
+        }
+    }
+#endif
+
     request req = request::create("initialize", {
         {"protocolVersion", MCP_VERSION},
-        {"capabilities", capabilities_},
+        {"capabilities", capabilities},
         {"clientInfo", {
             {"name", client_name},
             {"version", client_version}
         }}
     });
-    
+
     try {
         json result = send_jsonrpc(req);
-        
+
         server_capabilities_ = result["capabilities"];
-        
+
+        // Switch framing before the initialized notification goes out; the
+        // server flipped its reader when it accepted the offer
+        if (binary_requested_) {
+            bool accepted = server_capabilities_.contains("experimental") &&
+                            server_capabilities_["experimental"].contains("binary_framing") &&
+                            server_capabilities_["experimental"]["binary_framing"].value("accepted", false);
+            if (accepted) {
+                binary_active_.store(true, std::memory_order_release);
+                LOG_INFO("Binary stdio framing active (msgpack)");
+            } else {
+                LOG_INFO("Server declined binary framing, staying on newline-delimited JSON");
+            }
+        }
+
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+        if (shm_) {
+            bool accepted = server_capabilities_.contains("experimental") &&
+                            server_capabilities_["experimental"].contains("shm") &&
+                            server_capabilities_["experimental"]["shm"].value("accepted", false);
+            if (accepted) {
+                shm_read_thread_ = std::make_unique<std::thread>(&stdio_client::shm_read_thread_func, this);
+                shm_active_.store(true, std::memory_order_release);
+                LOG_INFO("Shared-memory channel active: ", shm_->name());
+            } else {
+                LOG_INFO("Server declined shared-memory channel, staying on pipe transport");
+                shm_.reset();
+            }
+        }
+#endif
+
         request notification = request::create_notification("initialized");
         send_jsonrpc(notification);
         
@@ -131,7 +198,11 @@ json stdio_client::call_tool(const std::string& tool_name, const json& arguments
 }
 
 std::vector<tool> stdio_client::get_tools() {
-    json response_json = send_request("tools/list", {}).result;
+    json response_json;
+    if (!cache_lookup("tools/list", response_json)) {
+        response_json = send_request("tools/list", {}).result;
+        cache_store("tools/list", response_json);
+    }
     std::vector<tool> tools;
     
     json tools_json;
@@ -166,14 +237,27 @@ json stdio_client::list_resources(const std::string& cursor) {
     json params = json::object();
     if (!cursor.empty()) {
         params["cursor"] = cursor;
+        // Paginated requests bypass the cache; only the first page is reused
+        return send_request("resources/list", params).result;
+    }
+    json result;
+    if (!cache_lookup("resources/list", result)) {
+        result = send_request("resources/list", params).result;
+        cache_store("resources/list", result);
     }
-    return send_request("resources/list", params).result;
+    return result;
 }
 
 json stdio_client::read_resource(const std::string& resource_uri) {
-    return send_request("resources/read", {
-        {"uri", resource_uri}
-    }).result;
+    json result;
+    const std::string cache_key = "resources/read:" + resource_uri;
+    if (!cache_lookup(cache_key, result)) {
+        result = send_request("resources/read", {
+            {"uri", resource_uri}
+        }).result;
+        cache_store(cache_key, result);
+    }
+    return result;
 }
 
 json stdio_client::subscribe_to_resource(const std::string& resource_uri) {
@@ -183,7 +267,12 @@ json stdio_client::subscribe_to_resource(const std::string& resource_uri) {
 }
 
 json stdio_client::list_resource_templates() {
-    return send_request("resources/templates/list").result;
+    json result;
+    if (!cache_lookup("resources/templates/list", result)) {
+        result = send_request("resources/templates/list").result;
+        cache_store("resources/templates/list", result);
+    }
+    return result;
 }
 
 bool stdio_client::is_running() const {
@@ -198,6 +287,29 @@ void stdio_client::set_environment_variables(const json& env_vars) {
     env_vars_ = env_vars;
 }
 
+void stdio_client::set_shm_transport(bool enabled, size_t ring_capacity) {
+    if (running_) {
+        LOG_WARNING("Cannot change shared-memory transport while server is running");
+        return;
+    }
+    shm_requested_ = enabled;
+    shm_ring_capacity_ = ring_capacity;
+#ifndef MCP_SHM_TRANSPORT_AVAILABLE
+    if (enabled) {
+        LOG_WARNING("Shared-memory transport is not available on this platform");
+        shm_requested_ = false;
+    }
+#endif
+}
+
+void stdio_client::set_binary_framing(bool enabled) {
+    if (running_) {
+        LOG_WARNING("Cannot change framing mode while server is running");
+        return;
+    }
+    binary_requested_ = enabled;
+}
+
 bool stdio_client::start_server_process() {
     if (running_) {
         LOG_INFO("Server process already running");
@@ -491,9 +603,22 @@ void stdio_client::stop_server_process() {
     }
     
     LOG_INFO("Stopping server process...");
-    
+
     running_ = false;
-    
+
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    // Tear down the shared-memory channel first so its reader exits promptly
+    shm_active_.store(false, std::memory_order_release);
+    if (shm_) {
+        shm_->close();
+    }
+    if (shm_read_thread_ && shm_read_thread_->joinable()) {
+        shm_read_thread_->join();
+    }
+    shm_read_thread_.reset();
+    shm_.reset();
+#endif
+
 #if defined(_WIN32)
     // Windows implementation
     // Close pipes
@@ -580,13 +705,122 @@ void stdio_client::stop_server_process() {
     LOG_INFO("Server process stopped");
 }
 
+void stdio_client::process_read_data(const char* data, size_t size) {
+    read_buffer_.append(data, size);
+
+    // Frame complete messages from the current offset; consumed bytes are
+    // skipped rather than erased, so framing stays linear in the input size.
+    // The framing mode can flip once, after initialize() accepted binary
+    // framing; everything after the initialize response is length-prefixed.
+    size_t offset = read_buffer_offset_;
+    while (offset < read_buffer_.size()) {
+        const char* base = read_buffer_.data();
+
+        if (!binary_active_.load(std::memory_order_acquire)) {
+            const char* newline = static_cast<const char*>(
+                std::memchr(base + offset, '\n', read_buffer_.size() - offset));
+            if (!newline) {
+                break;
+            }
+
+            size_t line_length = static_cast<size_t>(newline - (base + offset));
+            if (line_length > 0) {
+                handle_server_message(std::string_view(base + offset, line_length));
+            }
+            offset += line_length + 1;
+        } else {
+            if (read_buffer_.size() - offset < sizeof(uint32_t)) {
+                break;
+            }
+            uint32_t length = frame_get_le32(base + offset);
+            if (length > max_frame_size) {
+                // A desynced or corrupted stream; nothing after this point
+                // can be framed, so treat it as a dead transport
+                LOG_ERROR("Oversized binary frame (", length, " bytes), closing transport");
+                read_buffer_.clear();
+                read_buffer_offset_ = 0;
+                running_ = false;
+                return;
+            }
+            if (read_buffer_.size() - offset < sizeof(uint32_t) + length) {
+                break;
+            }
+            try {
+                handle_server_json(json::from_msgpack(
+                    std::string_view(base + offset + sizeof(uint32_t), length)));
+            } catch (const json::exception& e) {
+                LOG_WARNING("Dropping undecodable binary frame: ", e.what());
+            }
+            offset += sizeof(uint32_t) + length;
+        }
+    }
+    read_buffer_offset_ = offset;
+
+    // Drop the consumed prefix once everything was framed, or when it
+    // dominates the buffer
+    if (read_buffer_offset_ == read_buffer_.size()) {
+        read_buffer_.clear();
+        read_buffer_offset_ = 0;
+    } else if (read_buffer_offset_ >= 65536 && read_buffer_offset_ >= read_buffer_.size() / 2) {
+        read_buffer_.erase(0, read_buffer_offset_);
+        read_buffer_offset_ = 0;
+    }
+}
+
+void stdio_client::handle_server_message(std::string_view line) {
+    try {
+        handle_server_json(json::parse(line));
+    } catch (const json::exception& e) {
+        (e);
+        LOG_INFO("message: ", line);
+    }
+}
+
+void stdio_client::handle_server_json(const json& message) {
+    if (message.contains("jsonrpc") && message["jsonrpc"] == "2.0") {
+        if (message.contains("id") && !message["id"].is_null()) {
+            // This is a response
+            json id = message["id"];
+
+            std::lock_guard<std::mutex> lock(response_mutex_);
+            auto it = pending_requests_.find(id);
+
+            if (it != pending_requests_.end()) {
+                if (message.contains("result")) {
+                    it->second.set_value(message["result"]);
+                } else if (message.contains("error")) {
+                    json error_result = {
+                        {"isError", true},
+                        {"error", message["error"]}
+                    };
+                    it->second.set_value(error_result);
+                } else {
+                    it->second.set_value(json::object());
+                }
+
+                pending_requests_.erase(it);
+            } else {
+                LOG_WARNING("Received response for unknown request ID: ", id);
+            }
+        } else if (message.contains("method")) {
+            // This is a request or notification
+            LOG_INFO("Received request/notification: ", message["method"]);
+            cache_apply_notification(message["method"].get<std::string>(),
+                                     message.value("params", json::object()));
+            // Currently not handling requests from the server
+        }
+    }
+}
+
 void stdio_client::read_thread_func() {
     LOG_INFO("Read thread started");
-    
+
     const int buffer_size = 4096;
     char buffer[buffer_size];
-    std::string data_buffer;
-    
+
+    read_buffer_.clear();
+    read_buffer_offset_ = 0;
+
 #if defined(_WIN32)
     // Windows implementation
     DWORD bytes_read;
@@ -597,61 +831,12 @@ void stdio_client::read_thread_func() {
     
     while (running_) {
         // Read data
-        BOOL success = ReadFile(stdout_pipe_[0], buffer, buffer_size - 1, &bytes_read, NULL);
+        BOOL success = ReadFile(stdout_pipe_[0], buffer, buffer_size, &bytes_read, NULL);
         
         if (success && bytes_read > 0) {
             // Successfully read data
             retry_count = 0;  // Reset retry count
-            buffer[bytes_read] = '\0';
-            data_buffer.append(buffer, bytes_read);
-            
-            // Process complete JSON-RPC message
-            size_t pos = 0;
-            while ((pos = data_buffer.find('\n')) != std::string::npos) {
-                std::string line = data_buffer.substr(0, pos);
-                data_buffer.erase(0, pos + 1);
-                
-                if (!line.empty()) {
-                    try {
-                        json message = json::parse(line);
-                        
-                        if (message.contains("jsonrpc") && message["jsonrpc"] == "2.0") {
-                            if (message.contains("id") && !message["id"].is_null()) {
-                                // This is a response
-                                json id = message["id"];
-                                
-                                std::lock_guard<std::mutex> lock(response_mutex_);
-                                auto it = pending_requests_.find(id);
-                                
-                                if (it != pending_requests_.end()) {
-                                    if (message.contains("result")) {
-                                        it->second.set_value(message["result"]);
-                                    } else if (message.contains("error")) {
-                                        json error_result = {
-                                            {"isError", true},
-                                            {"error", message["error"]}
-                                        };
-                                        it->second.set_value(error_result);
-                                    } else {
-                                        it->second.set_value(json::object());
-                                    }
-                                    
-                                    pending_requests_.erase(it);
-                                } else {
-                                    LOG_WARNING("Received response for unknown request ID: ", id);
-                                }
-                            } else if (message.contains("method")) {
-                                // This is a request or notification
-                                LOG_INFO("Received request/notification: ", message["method"]);
-                                // Currently not handling requests from the server
-                            }
-                        }
-                    } catch (const json::exception& e) {
-                        (e);
-                        LOG_INFO("message: ", line);
-                    }
-                }
-            }
+            process_read_data(buffer, bytes_read);
         } else if (!success) {
             DWORD error = GetLastError();
             
@@ -709,58 +894,10 @@ void stdio_client::read_thread_func() {
     // POSIX implementation
     while (running_) {
         // Read data
-        ssize_t bytes_read = read(stdout_pipe_[0], buffer, buffer_size - 1);
+        ssize_t bytes_read = read(stdout_pipe_[0], buffer, buffer_size);
         
         if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            data_buffer.append(buffer, bytes_read);
-            
-            // Process complete JSON-RPC message
-            size_t pos = 0;
-            while ((pos = data_buffer.find('\n')) != std::string::npos) {
-                std::string line = data_buffer.substr(0, pos);
-                data_buffer.erase(0, pos + 1);
-                
-                if (!line.empty()) {
-                    try {
-                        json message = json::parse(line);
-                        
-                        if (message.contains("jsonrpc") && message["jsonrpc"] == "2.0") {
-                            if (message.contains("id") && !message["id"].is_null()) {
-                                // This is a response
-                                json id = message["id"];
-                                
-                                std::lock_guard<std::mutex> lock(response_mutex_);
-                                auto it = pending_requests_.find(id);
-                                
-                                if (it != pending_requests_.end()) {
-                                    if (message.contains("result")) {
-                                        it->second.set_value(message["result"]);
-                                    } else if (message.contains("error")) {
-                                        json error_result = {
-                                            {"isError", true},
-                                            {"error", message["error"]}
-                                        };
-                                        it->second.set_value(error_result);
-                                    } else {
-                                        it->second.set_value(json::object());
-                                    }
-                                    
-                                    pending_requests_.erase(it);
-                                } else {
-                                    LOG_WARNING("Received response for unknown request ID: ", id);
-                                }
-                            } else if (message.contains("method")) {
-                                // This is a request or notification
-                                LOG_INFO("Received request/notification: ", message["method"]);
-                                // Currently not handling requests from the server
-                            }
-                        }
-                    } catch (const json::exception& e) {
-                        LOG_INFO("message: ", line);
-                    }
-                }
-            }
+            process_read_data(buffer, bytes_read);
         } else if (bytes_read == 0) {
             // Pipe is closed
             LOG_WARNING("Pipe closed by server");
@@ -780,54 +917,123 @@ void stdio_client::read_thread_func() {
     LOG_INFO("Read thread stopped");
 }
 
-json stdio_client::send_jsonrpc(const request& req) {
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+void stdio_client::shm_read_thread_func() {
+    LOG_INFO("Shared-memory read thread started");
+
+    std::string frame;
+    while (running_ && shm_ && !shm_->is_closed()) {
+        if (!shm_->read_frame(frame, std::chrono::milliseconds(100))) {
+            continue;
+        }
+        if (!frame.empty() && frame.back() == '\n') {
+            frame.pop_back();
+        }
+        handle_server_message(std::string_view(frame));
+    }
+
+    LOG_INFO("Shared-memory read thread stopped");
+}
+#endif
+
+std::future<json> stdio_client::send_jsonrpc_async(const request& req) {
     if (!running_) {
         throw mcp_exception(error_code::internal_error, "Server process not running");
     }
-    
+
     json req_json = req.to_json();
-    std::string req_str = req_json.dump() + "\n";
-    
-#if defined(_WIN32)
-    // Windows implementation
-    DWORD bytes_written;
-    BOOL success = WriteFile(stdin_pipe_[1], req_str.c_str(), static_cast<DWORD>(req_str.size()), &bytes_written, NULL);
-    
-    if (!success || bytes_written != static_cast<DWORD>(req_str.size())) {
-        LOG_ERROR("Failed to write complete request: ", GetLastError());
-        throw mcp_exception(error_code::internal_error, "Failed to write to pipe");
+    std::string req_str;
+    if (binary_active_.load(std::memory_order_acquire)) {
+        std::vector<uint8_t> body = json::to_msgpack(req_json);
+        uint32_t length = static_cast<uint32_t>(body.size());
+        req_str.assign(sizeof(length) + body.size(), '\0');
+        frame_put_le32(&req_str[0], length);
+        std::memcpy(&req_str[sizeof(length)], body.data(), body.size());
+    } else {
+        req_str = req_json.dump() + "\n";
+    }
+
+    // Register the pending entry before the frame hits the pipe, so a fast
+    // response can never arrive before its promise exists
+    std::future<json> response_future;
+    if (!req.is_notification()) {
+        std::promise<json> response_promise;
+        response_future = response_promise.get_future();
+
+        std::lock_guard<std::mutex> lock(response_mutex_);
+        pending_requests_[req.id] = std::move(response_promise);
+    }
+
+    bool write_ok = true;
+    bool sent_via_shm = false;
+#ifdef MCP_SHM_TRANSPORT_AVAILABLE
+    // Fast path: small frames go through the shared-memory ring; write_frame
+    // declines frames that can never fit, which then take the pipe below.
+    // The channel always carries text JSON regardless of the pipe's framing
+    // mode, so the two transports stay independent.
+    if (shm_active_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        sent_via_shm = shm_->write_frame(
+            binary_active_.load(std::memory_order_acquire) ? req_json.dump() + "\n" : req_str);
     }
+#endif
+    if (!sent_via_shm) {
+        // One frame at a time; interleaved writes from pipelined callers
+        // would corrupt the stream
+        std::lock_guard<std::mutex> lock(write_mutex_);
+
+#if defined(_WIN32)
+        // Windows implementation
+        DWORD bytes_written;
+        BOOL success = WriteFile(stdin_pipe_[1], req_str.c_str(), static_cast<DWORD>(req_str.size()), &bytes_written, NULL);
+
+        write_ok = success && bytes_written == static_cast<DWORD>(req_str.size());
 #else
-    // POSIX implementation
-    ssize_t bytes_written = write(stdin_pipe_[1], req_str.c_str(), req_str.size());
-    
-    if (bytes_written != static_cast<ssize_t>(req_str.size())) {
-        LOG_ERROR("Failed to write complete request: ", strerror(errno));
+        // POSIX implementation; frames larger than PIPE_BUF may be written
+        // in several chunks
+        size_t total_written = 0;
+        while (total_written < req_str.size()) {
+            ssize_t bytes_written = write(stdin_pipe_[1], req_str.data() + total_written,
+                                          req_str.size() - total_written);
+            if (bytes_written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                write_ok = false;
+                break;
+            }
+            total_written += static_cast<size_t>(bytes_written);
+        }
+#endif
+    }
+
+    if (!write_ok) {
+        if (!req.is_notification()) {
+            std::lock_guard<std::mutex> lock(response_mutex_);
+            pending_requests_.erase(req.id);
+        }
+        LOG_ERROR("Failed to write complete request");
         throw mcp_exception(error_code::internal_error, "Failed to write to pipe");
     }
-#endif
-    
-    // If this is a notification, no need to wait for a response
+
+    // Notifications complete immediately
     if (req.is_notification()) {
-        return json::object();
+        std::promise<json> done;
+        done.set_value(json::object());
+        return done.get_future();
     }
-    
-    // Create Promise and Future
-    std::promise<json> response_promise;
-    std::future<json> response_future = response_promise.get_future();
-    
-    {
-        std::lock_guard<std::mutex> lock(response_mutex_);
-        pending_requests_[req.id] = std::move(response_promise);
-    }
-    
+
+    return response_future;
+}
+
+json stdio_client::wait_for_response(std::future<json>& response_future, const json& id) {
     // Wait for response, set timeout
     const auto timeout = std::chrono::seconds(60);
     auto status = response_future.wait_for(timeout);
-    
+
     if (status == std::future_status::ready) {
         json response = response_future.get();
-        
+
         if (response.contains("isError") && response["isError"].is_boolean() && response["isError"].get<bool>()) {
             if (response.contains("error") && response["error"].is_object()) {
                 const auto& err_obj = response["error"];
@@ -837,16 +1043,49 @@ json stdio_client::send_jsonrpc(const request& req) {
                 throw mcp_exception(static_cast<error_code>(code), message);
             }
         }
-        
+
         return response;
     } else {
         {
             std::lock_guard<std::mutex> lock(response_mutex_);
-            pending_requests_.erase(req.id);
+            pending_requests_.erase(id);
         }
-        
+
         throw mcp_exception(error_code::internal_error, "Timeout waiting for response");
     }
 }
 
+json stdio_client::send_jsonrpc(const request& req) {
+    std::future<json> response_future = send_jsonrpc_async(req);
+
+    if (req.is_notification()) {
+        return json::object();
+    }
+
+    return wait_for_response(response_future, req.id);
+}
+
+std::future<response> stdio_client::send_request_async(const std::string& method, const json& params) {
+    if (!running_) {
+        throw mcp_exception(error_code::internal_error, "Server process not running");
+    }
+
+    request req = request::create(method, params);
+    std::future<json> response_future = send_jsonrpc_async(req);
+
+    // The write already happened above; the deferred task only waits for
+    // completion, so many requests can be outstanding simultaneously
+    return std::async(std::launch::deferred,
+        [this, id = req.id, future = std::move(response_future)]() mutable -> response {
+            json result = wait_for_response(future, id);
+
+            response res;
+            res.jsonrpc = "2.0";
+            res.id = id;
+            res.result = std::move(result);
+
+            return res;
+        });
+}
+
 } // namespace mcp 
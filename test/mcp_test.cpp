@@ -13,6 +13,9 @@
 #include "mcp_tool.h"
 #include "mcp_prompt.h"
 #include "mcp_sse_client.h"
+#include "mcp_session_registry.h"
+#include "mcp_json_scan.h"
+#include "base64.hpp"
 
 #include <vector>
 #include <sstream>
@@ -879,3 +882,534 @@ TEST_F(StdioTransportTest, StartStdioProcessing) {
     EXPECT_TRUE(found_init_result) << "Missing initialize response";
     EXPECT_TRUE(found_tool_result) << "Missing tools/call response";
 }
+
+// Test session registry
+class SessionRegistryTest : public ::testing::Test {
+protected:
+    session_registry registry;
+};
+
+// Test adding, looking up and removing sessions
+TEST_F(SessionRegistryTest, AddFindRemove) {
+    EXPECT_TRUE(registry.try_add_session("s1", std::make_shared<event_dispatcher>()));
+    EXPECT_TRUE(registry.contains("s1"));
+    EXPECT_EQ(registry.session_count(), 1u);
+
+    // A duplicate ID keeps the existing entry
+    EXPECT_FALSE(registry.try_add_session("s1", std::make_shared<event_dispatcher>()));
+    EXPECT_EQ(registry.session_count(), 1u);
+
+    // Every session gets a dispatcher and a context
+    EXPECT_NE(registry.find_dispatcher("s1"), nullptr);
+    EXPECT_NE(registry.find_context("s1"), nullptr);
+    EXPECT_EQ(registry.find_dispatcher("missing"), nullptr);
+    EXPECT_EQ(registry.find_context("missing"), nullptr);
+
+    // Removal hands the resources back to the caller
+    auto removed = registry.remove_session("s1");
+    EXPECT_NE(removed.dispatcher, nullptr);
+    EXPECT_NE(removed.context, nullptr);
+    EXPECT_FALSE(registry.contains("s1"));
+    EXPECT_EQ(registry.session_count(), 0u);
+
+    // Removing an unknown session is harmless
+    auto missing = registry.remove_session("missing");
+    EXPECT_EQ(missing.dispatcher, nullptr);
+}
+
+// Test the concurrent session limit
+TEST_F(SessionRegistryTest, SessionLimit) {
+    const unsigned int max_sessions = 3;
+    for (unsigned int i = 0; i < max_sessions; i++) {
+        EXPECT_TRUE(registry.try_add_session("s" + std::to_string(i),
+                                             std::make_shared<event_dispatcher>(),
+                                             max_sessions));
+    }
+
+    // The limit rejects the next session without touching the registry
+    EXPECT_FALSE(registry.try_add_session("overflow",
+                                          std::make_shared<event_dispatcher>(),
+                                          max_sessions));
+    EXPECT_FALSE(registry.contains("overflow"));
+    EXPECT_EQ(registry.session_count(), max_sessions);
+
+    // Removing a session frees its slot
+    registry.remove_session("s0");
+    EXPECT_TRUE(registry.try_add_session("overflow",
+                                         std::make_shared<event_dispatcher>(),
+                                         max_sessions));
+
+    // 0 means unlimited
+    EXPECT_TRUE(registry.try_add_session("extra", std::make_shared<event_dispatcher>(), 0));
+}
+
+// Test the expiry wheel: idle sessions expire, active ones are re-armed,
+// removed ones are dropped from the sweep
+TEST_F(SessionRegistryTest, ExpiryWheel) {
+    using clock = std::chrono::steady_clock;
+    const auto timeout = std::chrono::seconds(1);
+    const auto now = clock::now();
+
+    registry.try_add_session("idle", std::make_shared<event_dispatcher>());
+    registry.try_add_session("busy", std::make_shared<event_dispatcher>());
+
+    std::map<std::string, clock::time_point> last_activity = {
+        {"idle", now - std::chrono::seconds(5)},
+        {"busy", now}
+    };
+    auto last_activity_of = [&](const std::string& session_id) {
+        auto it = last_activity.find(session_id);
+        return it == last_activity.end() ? clock::time_point::min() : it->second;
+    };
+
+    registry.arm_expiry("idle", now - std::chrono::seconds(1));
+    registry.arm_expiry("busy", now - std::chrono::seconds(1));
+    registry.arm_expiry("gone", now - std::chrono::seconds(1));
+
+    // First sweep: only the idle session expires; "gone" no longer exists
+    // and is dropped; "busy" is still active and gets re-armed
+    auto expired = registry.collect_expired(timeout, last_activity_of);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], "idle");
+
+    // Nothing is due before the re-armed deadline passes
+    expired = registry.collect_expired(timeout, last_activity_of);
+    EXPECT_TRUE(expired.empty());
+
+    // Once the re-armed deadline passes without new activity, the busy
+    // session expires on the next sweep
+    std::this_thread::sleep_for(timeout + std::chrono::milliseconds(200));
+    expired = registry.collect_expired(timeout, last_activity_of);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], "busy");
+}
+
+// Test the streaming JSON-RPC envelope scanner
+class JsonScanTest : public ::testing::Test {};
+
+// Test envelope extraction from a well-formed request body
+TEST_F(JsonScanTest, ExtractsEnvelopeFields) {
+    std::string body = R"({"jsonrpc": "2.0", "id": 7, "method": "tools/call", )"
+                       R"("params": {"name": "echo", "arguments": {"text": "a,\"b\" }"}}})";
+
+    json_scan::jsonrpc_envelope env;
+    ASSERT_TRUE(json_scan::scan_jsonrpc_envelope(body, env));
+    EXPECT_EQ(env.jsonrpc, "2.0");
+    EXPECT_EQ(env.id_raw, "7");
+    EXPECT_EQ(env.method, "tools/call");
+
+    // The raw params range parses to the same tree a DOM parse would build,
+    // including escaped quotes and braces inside strings
+    json params = json::parse(env.params_raw);
+    EXPECT_EQ(params["name"], "echo");
+    EXPECT_EQ(params["arguments"]["text"], "a,\"b\" }");
+}
+
+// Test that member order and missing fields are handled
+TEST_F(JsonScanTest, FieldOrderAndOmission) {
+    // Params before method, string id, extra members, loose whitespace
+    std::string body = "  {\n  \"params\" : [1, {\"k\": [2, 3]}],\n  \"extra\": null,\n"
+                       "  \"id\" : \"abc\",\n  \"method\": \"ping\",\n  \"jsonrpc\": \"2.0\"\n}  ";
+
+    json_scan::jsonrpc_envelope env;
+    ASSERT_TRUE(json_scan::scan_jsonrpc_envelope(body, env));
+    EXPECT_EQ(env.jsonrpc, "2.0");
+    EXPECT_EQ(env.id_raw, "\"abc\"");
+    EXPECT_EQ(env.method, "ping");
+    EXPECT_EQ(json::parse(env.params_raw), json::parse("[1, {\"k\": [2, 3]}]"));
+
+    // A notification without params leaves the range empty
+    json_scan::jsonrpc_envelope notification;
+    ASSERT_TRUE(json_scan::scan_jsonrpc_envelope(
+        R"({"jsonrpc": "2.0", "method": "notifications/initialized"})", notification));
+    EXPECT_EQ(notification.method, "notifications/initialized");
+    EXPECT_TRUE(notification.params_raw.empty());
+    EXPECT_TRUE(notification.id_raw.empty());
+}
+
+// Test that malformed bodies are rejected so the caller falls back to a
+// full DOM parse
+TEST_F(JsonScanTest, RejectsMalformedBodies) {
+    json_scan::jsonrpc_envelope env;
+
+    // Empty and non-object bodies (batch arrays take the DOM path)
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope("", env));
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope("   ", env));
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"([{"jsonrpc": "2.0"}])", env));
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope("42", env));
+
+    // Structural damage
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"method" "ping"})", env));       // missing colon
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"method": "ping")", env));       // truncated
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"method": "ping)", env));        // unterminated string
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"params": {"a": [1, 2}})", env)); // mismatched nesting
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"id": })", env));                // missing value
+    EXPECT_FALSE(json_scan::scan_jsonrpc_envelope(R"({"id": 1 "method": "ping"})", env)); // missing comma
+}
+
+// Test the base64 bulk kernels against the iterator reference path
+class Base64Test : public ::testing::Test {
+protected:
+    // The iterator overloads take the original byte-at-a-time path, so they
+    // serve as the reference the SIMD/table kernels must agree with
+    static std::string reference_encode(const std::string& in) {
+        std::string out;
+        base64::encode(in.begin(), in.end(), std::back_inserter(out));
+        return out;
+    }
+
+    static std::string reference_decode(const std::string& in) {
+        std::string out;
+        base64::decode(in.begin(), in.end(), std::back_inserter(out));
+        return out;
+    }
+
+    // Deterministic pseudo-random bytes covering the full value range
+    static std::string make_bytes(size_t size, uint32_t seed) {
+        std::string bytes(size, '\0');
+        uint32_t state = seed;
+        for (size_t i = 0; i < size; i++) {
+            state = state * 1664525u + 1013904223u;
+            bytes[i] = static_cast<char>(state >> 24);
+        }
+        return bytes;
+    }
+};
+
+// Test that the bulk encoder matches the reference and round-trips for
+// every length around the kernel block boundaries
+TEST_F(Base64Test, EncodeDecodeRoundTrip) {
+    // Lengths 0..96 cover every remainder of the 3-byte groups and several
+    // multiples of the 24-byte SIMD blocks
+    for (size_t size = 0; size <= 96; size++) {
+        std::string input = make_bytes(size, static_cast<uint32_t>(size) + 1);
+
+        std::string encoded = base64::encode(input);
+        EXPECT_EQ(encoded, reference_encode(input)) << "size=" << size;
+
+        EXPECT_EQ(base64::decode(encoded), input) << "size=" << size;
+        EXPECT_EQ(reference_decode(encoded), input) << "size=" << size;
+    }
+
+    // A larger buffer keeps the kernels in their bulk loop for many blocks
+    std::string large = make_bytes(64 * 1024 + 5, 42);
+    std::string encoded = base64::encode(large);
+    EXPECT_EQ(encoded, reference_encode(large));
+    EXPECT_EQ(base64::decode(encoded), large);
+}
+
+// Test decoding edge cases and invalid input
+TEST_F(Base64Test, DecodeEdgeCases) {
+    // Canonical test vectors
+    EXPECT_EQ(base64::encode(std::string("")), "");
+    EXPECT_EQ(base64::encode(std::string("f")), "Zg==");
+    EXPECT_EQ(base64::encode(std::string("fo")), "Zm8=");
+    EXPECT_EQ(base64::encode(std::string("foo")), "Zm9v");
+    EXPECT_EQ(base64::decode(std::string("Zm9vYmFy")), "foobar");
+
+    // Both alphabets are accepted on decode
+    std::string binary = make_bytes(32, 7);
+    std::string url_encoded = base64::encode(binary, base64::alphabet::url_filename_safe);
+    EXPECT_EQ(base64::decode(url_encoded), binary);
+
+    // Invalid characters after the padding are rejected
+    EXPECT_THROW(base64::decode(std::string("Zm8=!")), base64_error);
+}
+
+// Test binary length-prefixed stdio framing
+class BinaryFramingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Prepare original buffers
+        orig_cin = std::cin.rdbuf();
+        orig_cout = std::cout.rdbuf();
+    }
+
+    void TearDown() override {
+        // Restore buffers
+        std::cin.rdbuf(orig_cin);
+        std::cout.rdbuf(orig_cout);
+    }
+
+    // Frames are a 4-byte little-endian length prefix plus a MessagePack
+    // body; building the prefix byte-by-byte pins the wire byte order
+    static std::string make_frame(const json& message) {
+        std::vector<uint8_t> body = json::to_msgpack(message);
+        uint32_t length = static_cast<uint32_t>(body.size());
+        std::string frame;
+        frame.push_back(static_cast<char>(length & 0xff));
+        frame.push_back(static_cast<char>((length >> 8) & 0xff));
+        frame.push_back(static_cast<char>((length >> 16) & 0xff));
+        frame.push_back(static_cast<char>((length >> 24) & 0xff));
+        frame.append(reinterpret_cast<const char*>(body.data()), body.size());
+        return frame;
+    }
+
+    // Split raw server output into the newline-framed initialize response
+    // followed by binary response frames
+    static void parse_output(const std::string& raw, json& init_response,
+                             std::vector<json>& frames) {
+        size_t newline = raw.find('\n');
+        ASSERT_NE(newline, std::string::npos);
+        init_response = json::parse(raw.substr(0, newline));
+
+        size_t pos = newline + 1;
+        while (pos + 4 <= raw.size()) {
+            uint32_t length = static_cast<uint32_t>(static_cast<uint8_t>(raw[pos])) |
+                              (static_cast<uint32_t>(static_cast<uint8_t>(raw[pos + 1])) << 8) |
+                              (static_cast<uint32_t>(static_cast<uint8_t>(raw[pos + 2])) << 16) |
+                              (static_cast<uint32_t>(static_cast<uint8_t>(raw[pos + 3])) << 24);
+            pos += 4;
+            ASSERT_LE(pos + length, raw.size());
+            frames.push_back(json::from_msgpack(raw.substr(pos, length)));
+            pos += length;
+        }
+        EXPECT_EQ(pos, raw.size());
+    }
+
+    static json binary_init_request() {
+        return {
+            {"jsonrpc", "2.0"}, {"id", 0}, {"method", "initialize"},
+            {"params", {
+                {"protocolVersion", "2025-03-26"},
+                {"capabilities", {
+                    {"experimental", {
+                        {"binary_framing", {{"encoding", "msgpack"}}}
+                    }}
+                }},
+                {"clientInfo", {{"name", "test_client"}, {"version", "1.0"}}}
+            }}
+        };
+    }
+
+    std::streambuf* orig_cin;
+    std::streambuf* orig_cout;
+};
+
+// Test a full negotiate-then-round-trip exchange over the pipe
+TEST_F(BinaryFramingTest, RoundTrip) {
+    mcp::server::configuration srv_conf;
+    mcp::server server(srv_conf);
+
+    mcp::tool echo_tool = mcp::tool_builder("echo")
+        .with_description("Echo tool")
+        .with_string_param("text", "Text to echo", true)
+        .build();
+    server.register_tool(echo_tool, [](const mcp::json& params, const std::string&) -> mcp::json {
+        return {
+            {
+                {"type", "text"},
+                {"text", params["text"]}
+            }
+        };
+    });
+
+    // The initialize request goes out newline-framed; once the server
+    // accepts the offer, everything after it is length-prefixed
+    std::string input = binary_init_request().dump() + "\n";
+    input += make_frame({{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}});
+    input += make_frame({{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/call"},
+                         {"params", {{"name", "echo"},
+                                     {"arguments", {{"text", "hello binary"}}}}}});
+
+    std::istringstream in_stream(input);
+    std::ostringstream out_stream;
+    std::cin.rdbuf(in_stream.rdbuf());
+    std::cout.rdbuf(out_stream.rdbuf());
+
+    server.start_stdio();
+
+    json init_response;
+    std::vector<json> frames;
+    parse_output(out_stream.str(), init_response, frames);
+    if (::testing::Test::HasFatalFailure()) return;
+
+    // The offer was accepted in the initialize response
+    EXPECT_EQ(init_response["id"], 0);
+    EXPECT_EQ(init_response["result"]["capabilities"]["experimental"]["binary_framing"]["accepted"], true);
+
+    // The tool call response came back as a MessagePack frame
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0]["jsonrpc"], "2.0");
+    EXPECT_EQ(frames[0]["id"], 1);
+    EXPECT_EQ(frames[0]["result"]["content"][0]["text"], "hello binary");
+}
+
+// Test that an oversized length prefix closes the transport instead of
+// being trusted as an allocation size
+TEST_F(BinaryFramingTest, OversizedFrameClosesTransport) {
+    mcp::server::configuration srv_conf;
+    mcp::server server(srv_conf);
+
+    std::string input = binary_init_request().dump() + "\n";
+    input += make_frame({{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}});
+    // Corrupt prefix claiming a ~2 GiB frame, then a valid request that
+    // must never be answered because the stream is closed first
+    input += std::string("\xff\xff\xff\x7f", 4);
+    input += make_frame({{"jsonrpc", "2.0"}, {"id", 1}, {"method", "ping"}});
+
+    std::istringstream in_stream(input);
+    std::ostringstream out_stream;
+    std::cin.rdbuf(in_stream.rdbuf());
+    std::cout.rdbuf(out_stream.rdbuf());
+
+    server.start_stdio();
+
+    json init_response;
+    std::vector<json> frames;
+    parse_output(out_stream.str(), init_response, frames);
+    if (::testing::Test::HasFatalFailure()) return;
+
+    EXPECT_EQ(init_response["id"], 0);
+    EXPECT_TRUE(frames.empty()) << "request after the corrupt prefix was served";
+}
+
+// Test registry snapshots
+class RegistrySnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        snapshot_path = ::testing::TempDir() + "mcp_registry_snapshot_test.bin";
+        std::remove(snapshot_path.c_str());
+        // Prepare original buffers
+        orig_cin = std::cin.rdbuf();
+        orig_cout = std::cout.rdbuf();
+    }
+
+    void TearDown() override {
+        // Restore buffers
+        std::cin.rdbuf(orig_cin);
+        std::cout.rdbuf(orig_cout);
+        std::remove(snapshot_path.c_str());
+    }
+
+    // Register a small registry worth of definitions and write the snapshot
+    void build_and_save() {
+        mcp::server::configuration conf;
+        mcp::server source(conf);
+        for (int i = 0; i < 3; i++) {
+            mcp::tool t = mcp::tool_builder("tool_" + std::to_string(i))
+                .with_description("tool number " + std::to_string(i))
+                .with_string_param("arg", "an argument", true)
+                .build();
+            source.register_tool(t, [](const mcp::json&, const std::string&) -> mcp::json {
+                return mcp::json::array();
+            });
+        }
+        ASSERT_TRUE(source.save_registry_snapshot(snapshot_path));
+    }
+
+    // Feed the server request lines over stdio and collect the responses
+    static std::vector<json> run_requests(mcp::server& server, const std::vector<json>& requests) {
+        std::string input =
+            "{\"jsonrpc\": \"2.0\", \"id\": 0, \"method\": \"initialize\", \"params\": "
+            "{\"protocolVersion\": \"2025-03-26\", \"capabilities\": {}, "
+            "\"clientInfo\": {\"name\": \"test_client\", \"version\": \"1.0\"}}}\n"
+            "{\"jsonrpc\": \"2.0\", \"method\": \"notifications/initialized\"}\n";
+        for (const auto& req : requests) {
+            input += req.dump() + "\n";
+        }
+
+        std::istringstream in_stream(input);
+        std::ostringstream out_stream;
+        std::cin.rdbuf(in_stream.rdbuf());
+        std::cout.rdbuf(out_stream.rdbuf());
+
+        server.start_stdio();
+
+        std::istringstream output_stream(out_stream.str());
+        std::string line;
+        std::vector<json> responses;
+        while (std::getline(output_stream, line)) {
+            if (line.empty()) continue;
+            try {
+                json parsed = json::parse(line);
+                if (parsed.contains("id") && !parsed["id"].is_null() && parsed["id"] != 0) {
+                    responses.push_back(std::move(parsed));
+                }
+            } catch (...) {
+                continue;
+            }
+        }
+        return responses;
+    }
+
+    std::string snapshot_path;
+    std::streambuf* orig_cin;
+    std::streambuf* orig_cout;
+};
+
+// Test the save, load, bind round trip
+TEST_F(RegistrySnapshotTest, SaveLoadBindRoundTrip) {
+    build_and_save();
+    if (::testing::Test::HasFatalFailure()) return;
+
+    mcp::server::configuration conf;
+    mcp::server restored(conf);
+    ASSERT_TRUE(restored.load_registry_snapshot(snapshot_path));
+
+    // Binding attaches a handler to a snapshotted definition; unknown
+    // names are rejected
+    EXPECT_TRUE(restored.bind_tool_handler("tool_1",
+        [](const mcp::json& args, const std::string&) -> mcp::json {
+            return {
+                {
+                    {"type", "text"},
+                    {"text", args["arg"]}
+                }
+            };
+        }));
+    EXPECT_FALSE(restored.bind_tool_handler("no_such_tool", nullptr));
+
+    auto responses = run_requests(restored, {
+        {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}},
+        {{"jsonrpc", "2.0"}, {"id", 2}, {"method", "tools/call"},
+         {"params", {{"name", "tool_1"}, {"arguments", {{"arg", "from snapshot"}}}}}},
+        {{"jsonrpc", "2.0"}, {"id", 3}, {"method", "tools/call"},
+         {"params", {{"name", "tool_2"}, {"arguments", {{"arg", "x"}}}}}}
+    });
+    ASSERT_EQ(responses.size(), 3u);
+
+    // The full definitions, schemas included, came out of the snapshot
+    ASSERT_EQ(responses[0]["result"]["tools"].size(), 3u);
+    bool schema_ok = false;
+    for (const auto& t : responses[0]["result"]["tools"]) {
+        if (t["name"] == "tool_1") {
+            schema_ok = t["inputSchema"]["properties"].contains("arg");
+        }
+    }
+    EXPECT_TRUE(schema_ok);
+
+    // The bound tool serves calls; the unbound one fails with a clear error
+    EXPECT_EQ(responses[1]["result"]["content"][0]["text"], "from snapshot");
+    ASSERT_TRUE(responses[2].contains("error"));
+    EXPECT_NE(responses[2]["error"]["message"].get<std::string>().find("not bound"),
+              std::string::npos);
+}
+
+// Test that a corrupted snapshot is rejected by the payload hash
+TEST_F(RegistrySnapshotTest, TamperedSnapshotRejected) {
+    build_and_save();
+    if (::testing::Test::HasFatalFailure()) return;
+
+    // Flip one payload byte past the 24-byte header
+    std::string contents;
+    {
+        std::ifstream in(snapshot_path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        contents = buffer.str();
+    }
+    ASSERT_GT(contents.size(), 32u);
+    contents[30] ^= 0x5a;
+    {
+        std::ofstream out(snapshot_path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    }
+
+    mcp::server::configuration conf;
+    mcp::server server(conf);
+    EXPECT_FALSE(server.load_registry_snapshot(snapshot_path));
+
+    // A missing file is rejected the same way
+    EXPECT_FALSE(server.load_registry_snapshot(snapshot_path + ".missing"));
+}